@@ -483,7 +483,7 @@ const osThreadDef_t os_thread_def_##name = \
     (instances == 1) ? (&os_thread_cb_##name) : NULL,\
     (instances == 1) ? osThreadCbSize : 0U, \
     ((stacksz) && (instances == 1)) ? (&os_thread_stack##name) : NULL, \
-    8*((stacksz+7)/8), \
+    (stacksz) ? osThreadStackSize(stacksz) : 0U, \
     (priority), 0U, 0U } }
 #endif
 #endif
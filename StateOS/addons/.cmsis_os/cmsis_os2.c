@@ -56,6 +56,14 @@
 
 /* -------------------------------------------------------------------------- */
 
+// slab caches of the control blocks of fixed size allocated by osXxxNew functions
+static slb_t TimerSlab      = _SLB_INIT(osTimerCbSize);
+static slb_t EventFlagsSlab = _SLB_INIT(osEventFlagsCbSize);
+static slb_t MutexSlab      = _SLB_INIT(osMutexCbSize);
+static slb_t SemaphoreSlab  = _SLB_INIT(osSemaphoreCbSize);
+
+/* -------------------------------------------------------------------------- */
+
 osStatus_t osKernelInitialize (void)
 {
 	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
@@ -148,7 +156,7 @@ uint32_t osKernelGetTickFreq (void)
 
 uint32_t osKernelGetSysTimerCount (void)
 {
-#if HW_TIMER_SIZE
+#if HW_TIMER_SIZE || !defined(__CORTEX_M) // no SysTick on the host
 	return sys_time();
 #else
 	uint32_t cnt;
@@ -175,7 +183,7 @@ uint32_t osKernelGetSysTimerCount (void)
 
 uint32_t osKernelGetSysTimerFreq (void)
 {
-#if HW_TIMER_SIZE
+#if HW_TIMER_SIZE || !defined(__CORTEX_M) // no SysTick on the host
 	return  OS_FREQUENCY;
 #elif (CPU_FREQUENCY)/(OS_FREQUENCY)-1 <= SysTick_LOAD_RELOAD_Msk
 	return CPU_FREQUENCY;
@@ -256,7 +264,7 @@ osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAtt
 	sys_lock();
 	{
 		tsk_init(&thread->tsk, (attr == NULL) ? osPriorityNormal : attr->priority, thread_handler, stack_mem, stack_size);
-		if (attr->cb_mem    == NULL || attr->cb_size    == 0U) thread->tsk.hdr.obj.res = thread;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) thread->tsk.hdr.obj.res = thread;
 		else
 		if (attr->stack_mem == NULL || attr->stack_size == 0U) thread->tsk.hdr.obj.res = stack_mem;
 		thread->tsk.join = (flags & osThreadJoinable) ? JOINABLE : DETACHED;
@@ -446,9 +454,9 @@ uint32_t osThreadGetStackSpace (osThreadId_t thread_id)
 		return 0U;
 
 	if (&thread->tsk != tsk_this())
-		return (uint32_t) thread->tsk.sp - (uint32_t) thread->tsk.stack;
+		return (uint32_t)((size_t) thread->tsk.sp - (size_t) thread->tsk.stack);
 
-	return (uint32_t) port_get_sp() - (uint32_t) thread->tsk.stack;
+	return (uint32_t)((size_t) port_get_sp() - (size_t) thread->tsk.stack);
 }
 
 uint32_t osThreadGetCount (void)
@@ -467,7 +475,7 @@ uint32_t osThreadGetCount (void)
 		for (tsk = IDLE.hdr.next; tsk != &IDLE; tsk = tsk->hdr.next)
 			count++;
 
-		for (tmr = WAIT.hdr.next; tmr != &WAIT; tmr = tmr->hdr.next)
+		for (tmr = core_tmr_next(&WAIT); tmr != &WAIT; tmr = core_tmr_next(tmr))
 			if (tmr->hdr.id == ID_DELAYED)
 				count++;
 	}
@@ -492,7 +500,7 @@ uint32_t osThreadEnumerate (osThreadId_t *thread_array, uint32_t array_items)
 		for (tsk = IDLE.hdr.next; (tsk != &IDLE) && (count < array_items); tsk = tsk->hdr.next)
 			thread_array[count++] = tsk;
 
-		for (tmr = WAIT.hdr.next; (tmr != &WAIT) && (count < array_items); tmr = tmr->hdr.next)
+		for (tmr = core_tmr_next(&WAIT); (tmr != &WAIT) && (count < array_items); tmr = core_tmr_next(tmr))
 			if (tmr->hdr.id == ID_DELAYED)
 				thread_array[count++] = tmr;
 	}
@@ -607,7 +615,7 @@ osTimerId_t osTimerNew (osTimerFunc_t func, osTimerType_t type, void *argument,
 
 	if (timer == NULL)
 	{
-		timer = sys_alloc(osTimerCbSize);
+		timer = sys_slabAlloc(&TimerSlab);
 		if (timer == NULL)
 			return NULL;
 	}
@@ -615,7 +623,7 @@ osTimerId_t osTimerNew (osTimerFunc_t func, osTimerType_t type, void *argument,
 	sys_lock();
 	{
 		tmr_init(&timer->tmr, timer_handler);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) timer->tmr.hdr.obj.res = timer;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) timer->tmr.hdr.obj.res = SLB_RES(timer);
 		timer->flags = flags;
 		timer->name = (attr == NULL) ? NULL : attr->name;
 		timer->func = func;
@@ -710,7 +718,7 @@ osEventFlagsId_t osEventFlagsNew (const osEventFlagsAttr_t *attr)
 
 	if (ef == NULL)
 	{
-		ef = sys_alloc(osEventFlagsCbSize);
+		ef = sys_slabAlloc(&EventFlagsSlab);
 		if (ef == NULL)
 			return NULL;
 	}
@@ -718,7 +726,7 @@ osEventFlagsId_t osEventFlagsNew (const osEventFlagsAttr_t *attr)
 	sys_lock();
 	{
 		flg_init(&ef->flg, 0);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) ef->flg.obj.res = ef;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) ef->flg.obj.res = SLB_RES(ef);
 		ef->flags = flags;
 		ef->name = (attr == NULL) ? NULL : attr->name;
 	}
@@ -822,15 +830,15 @@ osMutexId_t osMutexNew (const osMutexAttr_t *attr)
 
 	if (mutex == NULL)
 	{
-		mutex = sys_alloc(osMutexCbSize);
+		mutex = sys_slabAlloc(&MutexSlab);
 		if (mutex == NULL)
 			return NULL;
 	}
 
 	sys_lock();
 	{
-		mtx_init(&mutex->mtx);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) mutex->mtx.obj.res = mutex;
+		mtx_init(&mutex->mtx, 0);
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) mutex->mtx.obj.res = SLB_RES(mutex);
 		mutex->flags = flags;
 		mutex->name = (attr == NULL) ? NULL : attr->name;
 	}
@@ -928,7 +936,7 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
 
 	if (semaphore == NULL)
 	{
-		semaphore = sys_alloc(osSemaphoreCbSize);
+		semaphore = sys_slabAlloc(&SemaphoreSlab);
 		if (semaphore == NULL)
 			return NULL;
 	}
@@ -936,7 +944,7 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
 	sys_lock();
 	{
 		sem_init(&semaphore->sem, initial_count, max_count);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) semaphore->sem.obj.res = semaphore;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) semaphore->sem.obj.res = SLB_RES(semaphore);
 		semaphore->flags = flags;
 		semaphore->name = (attr == NULL) ? NULL : attr->name;
 	}
@@ -1064,7 +1072,7 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
 	sys_lock();
 	{
 		mem_init(&mp->mem, block_size, data, size);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) mp->mem.lst.obj.res = mp;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) mp->mem.lst.obj.res = mp;
 		else
 		if (attr->mp_mem == NULL || attr->mp_size == 0U) mp->mem.lst.obj.res = data;
 		mp->flags = flags;
@@ -1145,6 +1153,7 @@ uint32_t osMemoryPoolGetCount (osMemoryPoolId_t mp_id)
 
 	sys_lock();
 	{
+		count -= mp->mem.spare;
 		for (que = mp->mem.lst.head.next; que != NULL; que = que->next) count--;
 	}
 	sys_unlock();
@@ -1163,6 +1172,7 @@ uint32_t osMemoryPoolGetSpace (osMemoryPoolId_t mp_id)
 
 	sys_lock();
 	{
+		count = mp->mem.spare;
 		for (que = mp->mem.lst.head.next; que != NULL; que = que->next) count++;
 	}
 	sys_unlock();
@@ -1238,7 +1248,7 @@ osMessageQueueId_t osMessageQueueNew (uint32_t msg_count, uint32_t msg_size, con
 	sys_lock();
 	{
 		box_init(&mq->box, msg_count, data, msg_size);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) mq->box.obj.res = mq;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) mq->box.obj.res = mq;
 		else
 		if (attr->mq_mem == NULL || attr->mq_size == 0U) mq->box.obj.res = data;
 		mq->flags = flags;
@@ -66,7 +66,7 @@ struct __Thread
 typedef struct __Thread osThread_t;
 
 #define osThreadCbSize sizeof(osThread_t)
-#define osThreadStackSize(size) (((((size)?(size):(OS_STACK_SIZE))+7)/8)*8)
+#define osThreadStackSize(size) (((STK_MIN((size)?(size):(OS_STACK_SIZE))+7)/8)*8)
 
 /*---------------------------------------------------------------------------*/
 
@@ -68,7 +68,7 @@ static OS_mut_sem_record_t   OS_mut_sem_table  [OS_MAX_MUTEXES];
 static OS_task_record_t      OS_task_table     [OS_MAX_TASKS];
 static OS_timer_record_t     OS_timer_table    [OS_MAX_TIMERS];
 
-static OS_time_t             localtime        = { 0, 0 };
+static OS_time_t             local_time       = { 0, 0 };
 static tmr_t                 local_timer      = TMR_INIT(0);
 static bool                  printf_enabled   = FALSE;
 
@@ -81,12 +81,12 @@ static void local_timer_handler( void )
 {
 	sys_lockISR();
 	{
-		localtime.microsecs += 1000;
+		local_time.microsecs += 1000;
 
-		if (localtime.microsecs >= 1000000)
+		if (local_time.microsecs >= 1000000)
 		{
-			localtime.microsecs = 0;
-			localtime.seconds++;
+			local_time.microsecs = 0;
+			local_time.seconds++;
 		}
 	}
 	sys_unlockISR();
@@ -149,7 +149,7 @@ int32 OS_GetLocalTime(OS_time_t *time_struct)
 {
 	sys_lock();
 	{
-		*time_struct = localtime;
+		*time_struct = local_time;
 	}
 	sys_unlock();
 
@@ -160,7 +160,7 @@ int32 OS_SetLocalTime(OS_time_t *time_struct)
 {
 	sys_lock();
 	{
-		localtime = *time_struct;
+		local_time = *time_struct;
 	}
 	sys_unlock();
 
@@ -818,7 +818,7 @@ int32 OS_MutSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 options
 				else
 				{
 					*semaphore_id = rec - OS_mut_sem_table;
-					mtx_init(&rec->mtx);
+					mtx_init(&rec->mtx, 0);
 					strcpy(rec->name, sem_name);
 					rec->creator = OS_TaskGetId();
 					rec->used = 1;
@@ -1185,7 +1185,7 @@ int32 OS_TaskGetInfo(uint32 task_id, OS_task_prop_t *task_prop)
 			task_prop->creator = rec->creator;
 			task_prop->stack_size = (uint32_t) rec->tsk.size;
 			task_prop->priority = ~rec->tsk.basic;
-			task_prop->OStask_id = (uint32) &rec->tsk;
+			task_prop->OStask_id = (uint32)(size_t) &rec->tsk;
 			status = OS_SUCCESS;
 		}
 	}
@@ -1285,14 +1285,24 @@ int32 OS_IntLock(void)
 
 int32 OS_IntEnable(int32 Level)
 {
+#if defined(__CORTEX_M)
 	NVIC_EnableIRQ((IRQn_Type)Level);
 	return OS_SUCCESS;
+#else // no interrupt controller on the host
+	(void) Level;
+	return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 int32 OS_IntDisable(int32 Level)
 {
+#if defined(__CORTEX_M)
 	NVIC_DisableIRQ((IRQn_Type)Level);
 	return OS_SUCCESS;
+#else // no interrupt controller on the host
+	(void) Level;
+	return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 int32 OS_IntSetMask(uint32 mask)
@@ -1309,8 +1319,13 @@ int32 OS_IntGetMask(uint32 *mask)
 
 int32 OS_IntAck(int32 InterruptNumber)
 {
+#if defined(__CORTEX_M)
 	NVIC_ClearPendingIRQ((IRQn_Type)InterruptNumber);
 	return OS_SUCCESS;
+#else // no interrupt controller on the host
+	(void) InterruptNumber;
+	return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1364,8 +1379,23 @@ int32 OS_ShMemGetIdByName(uint32 *ShMemId, const char *SegName)
 
 int32 OS_HeapGetInfo(OS_heap_prop_t *heap_prop)
 {
+#if OS_HEAP_STATS && OS_HEAP_SIZE
+	hst_t hst;
+
+	if (!heap_prop)
+		return OS_INVALID_POINTER;
+
+	sys_heapStats(&hst);
+
+	heap_prop->free_bytes         = hst.size - hst.used;
+	heap_prop->free_blocks        = hst.segs;
+	heap_prop->largest_free_block = hst.largest;
+
+	return OS_SUCCESS;
+#else
 	(void) heap_prop;
 	return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 /* -------------------------------------------------------------------------- */
@@ -60,6 +60,36 @@ lck_t core_sys_lock( void )
 	return lck;
 }
 
+#if OS_LOCK_STATS
+
+/******************************************************************************
+ *
+ * Name              : core_sys_lockAt
+ *
+ * Description       : disable interrupts, begin measurement of the lock window
+ *                     if the lock has been set at call site 'lcs' (OS_LOCK_STATS mode)
+ *
+ * Parameters
+ *   lcs             : pointer to statistics of the call site
+ *
+ * Return            : previous interrupts state
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+lck_t core_sys_lockAt( lcs_t *lcs )
+{
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	if (lck == 0)
+		core_lck_enter(lcs);
+	return lck;
+}
+
+#endif
+
 /******************************************************************************
  *
  * Name              : core_sys_unlock
@@ -78,6 +108,8 @@ lck_t core_sys_lock( void )
 __STATIC_INLINE
 void core_sys_unlock( lck_t lck )
 {
+	if (lck == 0)
+		core_lck_leave();
 	port_put_lock(lck);
 }
 
@@ -94,11 +126,17 @@ void core_sys_unlock( lck_t lck )
  * Return            : none
  *
  * Note              : may be used both in thread and handler mode
+ *                     in OS_LOCK_STATS mode the lock window is attributed to the place of the macro
  *
  ******************************************************************************/
 
+#if OS_LOCK_STATS
+#define                sys_lock() \
+                       do { static lcs_t __SITE = _LCS_INIT(); lck_t __LOCK = core_sys_lockAt(&__SITE)
+#else
 #define                sys_lock() \
                        do { lck_t __LOCK = core_sys_lock()
+#endif
 
 #define                sys_lockISR() \
                        sys_lock()
@@ -146,7 +184,11 @@ void core_sys_unlock( lck_t lck )
 
 struct CriticalSection
 {
+#if OS_LOCK_STATS
+	 CriticalSection( void ) { static lcs_t site = _LCS_INIT(); lck = core_sys_lockAt(&site); }
+#else
 	 CriticalSection( void ) { lck = core_sys_lock(); }
+#endif
 	~CriticalSection( void ) { core_sys_unlock(lck);  }
 
 	private:
@@ -296,6 +296,33 @@ void evt_give( evt_t *evt, unsigned event );
 __STATIC_INLINE
 void evt_giveISR( evt_t *evt, unsigned event ) { evt_give(evt, event); }
 
+#if OS_ISR_QUEUE
+
+/******************************************************************************
+ *
+ * Name              : evt_giveAsync
+ *
+ * Description       : post evt_give request to the queue of deferred procedures,
+ *                     the request will be executed in the context switch handler
+ *                     the kernel lock isn't used
+ *
+ * Parameters
+ *   evt             : pointer to event object
+ *   event           : event value
+ *
+ * Return
+ *   E_SUCCESS       : request was successfully posted
+ *   E_TIMEOUT       : queue of deferred procedures is full
+ *
+ * Note              : use only in handler mode
+ *                     result of the deferred evt_give procedure is lost
+ *
+ ******************************************************************************/
+
+unsigned evt_giveAsync( evt_t *evt, unsigned event );
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -326,6 +353,9 @@ struct Event : public __evt
 	unsigned wait     ( void )            { return evt_wait     (this);         }
 	void     give     ( unsigned _event ) {        evt_give     (this, _event); }
 	void     giveISR  ( unsigned _event ) {        evt_giveISR  (this, _event); }
+#if OS_ISR_QUEUE
+	unsigned giveAsync( unsigned _event ) { return evt_giveAsync(this, _event); }
+#endif
 };
 
 #endif//__cplusplus
@@ -437,6 +437,33 @@ unsigned evq_give( evq_t *evq, unsigned data );
 __STATIC_INLINE
 unsigned evq_giveISR( evq_t *evq, unsigned data ) { return evq_give(evq, data); }
 
+#if OS_ISR_QUEUE
+
+/******************************************************************************
+ *
+ * Name              : evq_giveAsync
+ *
+ * Description       : post evq_give request to the queue of deferred procedures,
+ *                     the request will be executed in the context switch handler
+ *                     the kernel lock isn't used
+ *
+ * Parameters
+ *   evq             : pointer to event queue object
+ *   data            : event value
+ *
+ * Return
+ *   E_SUCCESS       : request was successfully posted
+ *   E_TIMEOUT       : queue of deferred procedures is full
+ *
+ * Note              : use only in handler mode
+ *                     result of the deferred evq_give procedure is lost
+ *
+ ******************************************************************************/
+
+unsigned evq_giveAsync( evq_t *evq, unsigned data );
+
+#endif
+
 /******************************************************************************
  *
  * Name              : evq_push
@@ -498,6 +525,9 @@ struct EventQueueT : public __evq
 	unsigned send     ( unsigned  _data )               { return evq_send     (this, _data);         }
 	unsigned give     ( unsigned  _data )               { return evq_give     (this, _data);         }
 	unsigned giveISR  ( unsigned  _data )               { return evq_giveISR  (this, _data);         }
+#if OS_ISR_QUEUE
+	unsigned giveAsync( unsigned  _data )               { return evq_giveAsync(this, _data);         }
+#endif
 	unsigned push     ( unsigned  _data )               { return evq_push     (this, _data);         }
 	unsigned pushISR  ( unsigned  _data )               { return evq_pushISR  (this, _data);         }
 
@@ -381,6 +381,33 @@ unsigned flg_give( flg_t *flg, unsigned flags );
 __STATIC_INLINE
 unsigned flg_giveISR( flg_t *flg, unsigned flags ) { return flg_give(flg, flags); }
 
+#if OS_ISR_QUEUE
+
+/******************************************************************************
+ *
+ * Name              : flg_giveAsync
+ *
+ * Description       : post flg_give request to the queue of deferred procedures,
+ *                     the request will be executed in the context switch handler
+ *                     the kernel lock isn't used
+ *
+ * Parameters
+ *   flg             : pointer to flag object
+ *   flags           : all flags to be set
+ *
+ * Return
+ *   E_SUCCESS       : request was successfully posted
+ *   E_TIMEOUT       : queue of deferred procedures is full
+ *
+ * Note              : use only in handler mode
+ *                     result of the deferred flg_give procedure is lost
+ *
+ ******************************************************************************/
+
+unsigned flg_giveAsync( flg_t *flg, unsigned flags );
+
+#endif
+
 /******************************************************************************
  *
  * Name              : flg_clear
@@ -435,6 +462,9 @@ struct Flag : public __flg
 	unsigned takeISR  ( unsigned _flags, char _mode = flgAll )      { return flg_takeISR  (this, _flags, _mode);         }
 	unsigned give     ( unsigned _flags )                           { return flg_give     (this, _flags);                }
 	unsigned giveISR  ( unsigned _flags )                           { return flg_giveISR  (this, _flags);                }
+#if OS_ISR_QUEUE
+	unsigned giveAsync( unsigned _flags )                           { return flg_giveAsync(this, _flags);                }
+#endif
 	unsigned clear    ( unsigned _flags )                           { return flg_clear    (this, _flags);                }
 	unsigned clearISR ( unsigned _flags )                           { return flg_clearISR (this, _flags);                }
 };
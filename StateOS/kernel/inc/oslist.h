@@ -80,6 +80,7 @@ struct __lst
 	obj_t    obj;   // object header
 
 	que_t    head;  // list head
+	que_t  * tail;  // last object in the list, zero if the list is empty
 };
 
 /******************************************************************************
@@ -96,7 +97,7 @@ struct __lst
  *
  ******************************************************************************/
 
-#define               _LST_INIT() { _OBJ_INIT(), _QUE_INIT() }
+#define               _LST_INIT() { _OBJ_INIT(), _QUE_INIT(), 0 }
 
 /******************************************************************************
  *
@@ -358,6 +359,33 @@ void lst_give( lst_t *lst, const void *data );
 __STATIC_INLINE
 void lst_giveISR( lst_t *lst, const void *data ) { lst_give(lst, data); }
 
+/******************************************************************************
+ *
+ * Name              : lst_giveOrdered
+ * ISR alias         : lst_giveOrderedISR
+ *
+ * Description       : transfer memory object to the list object,
+ *                     the memory object is inserted before the first object of lower priority
+ *
+ * Parameters
+ *   lst             : pointer to list object
+ *   data            : pointer to memory object
+ *   cmp             : comparison procedure, it returns a value greater than zero,
+ *                     if the first memory object has higher priority than the second one
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     objects of equal priority keep their order (FIFO)
+ *                     the list is searched with the kernel locked, so the time depends on the position of the object
+ *
+ ******************************************************************************/
+
+void lst_giveOrdered( lst_t *lst, const void *data, int (*cmp)( const void *, const void * ) );
+
+__STATIC_INLINE
+void lst_giveOrderedISR( lst_t *lst, const void *data, int (*cmp)( const void *, const void * ) ) { lst_giveOrdered(lst, data, cmp); }
+
 #ifdef __cplusplus
 }
 #endif
@@ -391,6 +419,8 @@ struct ListTT : public __lst
 	unsigned takeISR  (       T   **_data )               { return lst_takeISR  (this, reinterpret_cast<void **>(_data));         }
 	void     give     ( const void *_data )               {        lst_give     (this,                           _data);          }
 	void     giveISR  ( const void *_data )               {        lst_giveISR  (this,                           _data);          }
+	void     giveOrdered   ( const void *_data, int (*_cmp)( const void *, const void * ) ) { lst_giveOrdered   (this, _data, _cmp); }
+	void     giveOrderedISR( const void *_data, int (*_cmp)( const void *, const void * ) ) { lst_giveOrderedISR(this, _data, _cmp); }
 };
 
 /* -------------------------------------------------------------------------- */
@@ -33,6 +33,7 @@
 #define __STATEOS_BOX_H
 
 #include "oskernel.h"
+#include "oscriticalsection.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -566,14 +567,99 @@ struct MailBoxQueueT : public __box
  *
  * Constructor parameters
  *   limit           : size of a queue (max number of stored mails)
- *   T               : class of a single mail
+ *   T               : class of a single mail (trivially copyable)
+ *
+ * Note              : mails are copied by typed assignment, size of a mail and capacity of the queue are constants;
+ *                     if the capacity (in bytes) is a power of two, positions in the buffer are wrapped by masking;
+ *                     when there are tasks waiting for the mailbox queue or the operation must wait,
+ *                     the corresponding box_xxx function is called
  *
  ******************************************************************************/
 
 template<unsigned limit_, class T>
-struct MailBoxQueueTT : public MailBoxQueueT<limit_, sizeof(T)>
+struct MailBoxQueueTT : public __box
 {
-	MailBoxQueueTT( void ): MailBoxQueueT<limit_, sizeof(T)>() {}
+	 MailBoxQueueTT( void ): __box _BOX_INIT(limit_, reinterpret_cast<char *>(data_), sizeof(T)) {}
+	~MailBoxQueueTT( void ) { assert(__box::obj.queue == nullptr); }
+
+	void     kill     ( void )                         {        box_kill     (this);                                           }
+	unsigned waitFor  (       T *_data, cnt_t _delay ) { return get_(_data) ? E_SUCCESS : box_waitFor  (this, _data, _delay); }
+	unsigned waitUntil(       T *_data, cnt_t _time )  { return get_(_data) ? E_SUCCESS : box_waitUntil(this, _data, _time);  }
+	unsigned wait     (       T *_data )               { return get_(_data) ? E_SUCCESS : box_wait     (this, _data);         }
+	unsigned take     (       T *_data )               { return get_(_data) ? E_SUCCESS : box_take     (this, _data);         }
+	unsigned takeISR  (       T *_data )               { return get_(_data) ? E_SUCCESS : box_takeISR  (this, _data);         }
+	unsigned sendFor  ( const T *_data, cnt_t _delay ) { return put_(_data) ? E_SUCCESS : box_sendFor  (this, _data, _delay); }
+	unsigned sendUntil( const T *_data, cnt_t _time )  { return put_(_data) ? E_SUCCESS : box_sendUntil(this, _data, _time);  }
+	unsigned send     ( const T *_data )               { return put_(_data) ? E_SUCCESS : box_send     (this, _data);         }
+	unsigned give     ( const T *_data )               { return put_(_data) ? E_SUCCESS : box_give     (this, _data);         }
+	unsigned giveISR  ( const T *_data )               { return put_(_data) ? E_SUCCESS : box_giveISR  (this, _data);         }
+	unsigned push     ( const T *_data )               { return put_(_data, true) ? E_SUCCESS : box_push(this, _data);        }
+	unsigned pushISR  ( const T *_data )               { return put_(_data, true) ? E_SUCCESS : box_pushISR(this, _data);     }
+	unsigned count    ( void )                         { return __box::count / sizeof(T);                                    }
+	unsigned countISR ( void )                         { return __box::count / sizeof(T);                                    }
+	unsigned space    ( void )                         { return limit_ - __box::count / sizeof(T);                           }
+	unsigned spaceISR ( void )                         { return limit_ - __box::count / sizeof(T);                           }
+
+	private:
+	T data_[limit_];
+
+	static const unsigned size_ = limit_ * sizeof(T);
+
+	static
+	unsigned next_( unsigned _pos )
+	{
+		_pos += sizeof(T);
+		if ((size_ & (size_ - 1)) == 0)
+			return _pos & (size_ - 1);
+		return (_pos < size_) ? _pos : 0;
+	}
+
+	bool get_( T *_data )
+	{
+		bool result = false;
+
+		assert(_data);
+
+		sys_lock();
+		{
+			if (__box::count > 0 && __box::obj.queue == nullptr)
+			{
+				*_data = *reinterpret_cast<T *>(__box::data + __box::head);
+				__box::head = next_(__box::head);
+				__box::count -= sizeof(T);
+				result = true;
+			}
+		}
+		sys_unlock();
+
+		return result;
+	}
+
+	bool put_( const T *_data, bool _push = false )
+	{
+		bool result = false;
+
+		assert(_data);
+
+		sys_lock();
+		{
+			if (__box::obj.queue == nullptr && (__box::count < size_ || _push))
+			{
+				if (__box::count == size_)
+				{
+					__box::head = next_(__box::head);
+					__box::count -= sizeof(T);
+				}
+				*reinterpret_cast<T *>(__box::data + __box::tail) = *_data;
+				__box::tail = next_(__box::tail);
+				__box::count += sizeof(T);
+				result = true;
+			}
+		}
+		sys_unlock();
+
+		return result;
+	}
 };
 
 #endif//__cplusplus
@@ -59,6 +59,7 @@ struct __mem
 	unsigned limit; // size of a memory pool (max number of objects)
 	unsigned size;  // size of memory object (in sizeof(que_t) units)
 	que_t  * data;  // pointer to memory pool buffer
+	unsigned spare; // number of memory objects at the end of the buffer that have never been taken (untouched region)
 };
 
 /******************************************************************************
@@ -78,7 +79,7 @@ struct __mem
  *
  ******************************************************************************/
 
-#define               _MEM_INIT( _limit, _size, _data ) { _LST_INIT(), _limit, _size, _data }
+#define               _MEM_INIT( _limit, _size, _data ) { _LST_INIT(), _limit, _size, _data, _limit }
 
 /******************************************************************************
  *
@@ -193,6 +194,8 @@ struct __mem
  * Return            : none
  *
  * Note              : use only in thread mode
+ *                     the buffer isn't traversed, memory objects are taken from the untouched part of the buffer
+ *                     and then from the list of released objects; objects taken before are lost
  *
  ******************************************************************************/
 
@@ -298,8 +301,7 @@ void mem_delete( mem_t *mem );
  *
  ******************************************************************************/
 
-__STATIC_INLINE
-unsigned mem_waitFor( mem_t *mem, void **data, cnt_t delay ) { return lst_waitFor(&mem->lst, data, delay); }
+unsigned mem_waitFor( mem_t *mem, void **data, cnt_t delay );
 
 /******************************************************************************
  *
@@ -322,8 +324,7 @@ unsigned mem_waitFor( mem_t *mem, void **data, cnt_t delay ) { return lst_waitFo
  *
  ******************************************************************************/
 
-__STATIC_INLINE
-unsigned mem_waitUntil( mem_t *mem, void **data, cnt_t time ) { return lst_waitUntil(&mem->lst, data, time); }
+unsigned mem_waitUntil( mem_t *mem, void **data, cnt_t time );
 
 /******************************************************************************
  *
@@ -345,7 +346,7 @@ unsigned mem_waitUntil( mem_t *mem, void **data, cnt_t time ) { return lst_waitU
  ******************************************************************************/
 
 __STATIC_INLINE
-unsigned mem_wait( mem_t *mem, void **data ) { return lst_wait(&mem->lst, data); }
+unsigned mem_wait( mem_t *mem, void **data ) { return mem_waitFor(mem, data, INFINITE); }
 
 /******************************************************************************
  *
@@ -367,11 +368,10 @@ unsigned mem_wait( mem_t *mem, void **data ) { return lst_wait(&mem->lst, data);
  *
  ******************************************************************************/
 
-__STATIC_INLINE
-unsigned mem_take( mem_t *mem, void **data ) { return lst_take(&mem->lst, data); }
+unsigned mem_take( mem_t *mem, void **data );
 
 __STATIC_INLINE
-unsigned mem_takeISR( mem_t *mem, void **data ) { return lst_takeISR(&mem->lst, data); }
+unsigned mem_takeISR( mem_t *mem, void **data ) { return mem_take(mem, data); }
 
 /******************************************************************************
  *
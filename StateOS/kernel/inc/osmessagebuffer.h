@@ -56,8 +56,30 @@ struct __msg
 	unsigned head;  // inherited from stream buffer
 	unsigned tail;  // inherited from stream buffer
 	char   * data;  // inherited from stream buffer
+
+	unsigned resv;  // size of the message reserved by msg_reserve, zero if there is no reservation
+	unsigned peek;  // size of the message accessed by msg_peek, zero if there is no access
+	bool     send;  // the delayed queue contains senders (valid if the queue isn't empty)
+	tsk_t  * wait;  // receivers waiting for the release of the message accessed by msg_peek
 };
 
+/******************************************************************************
+ *
+ * Name              : region of message buffer
+ *
+ * Description       : place of a message in the data buffer of the message buffer object (zero-copy access)
+ *                     the message may wrap around the end of the data buffer, so the region consists of two parts:
+ *                     data[0] of size[0] bytes and data[1] (the beginning of the data buffer) of size[1] bytes
+ *                     size[1] is zero if the message doesn't wrap around
+ *
+ ******************************************************************************/
+
+typedef struct __rgn
+{
+	char   * data[2];
+	unsigned size[2];
+}	rgn_t;
+
 /******************************************************************************
  *
  * Name              : _MSG_INIT
@@ -74,7 +96,7 @@ struct __msg
  *
  ******************************************************************************/
 
-#define               _MSG_INIT( _limit, _data ) { _OBJ_INIT(), 0, _limit, 0, 0, _data }
+#define               _MSG_INIT( _limit, _data ) { _OBJ_INIT(), 0, _limit, 0, 0, _data, 0, 0, false, 0 }
 
 /******************************************************************************
  *
@@ -269,6 +291,7 @@ void msg_delete( msg_t *msg );
  *
  * Description       : try to transfer data from the message buffer object,
  *                     wait for given duration of time while the message buffer object is empty
+ *                     or its first message is accessed by msg_peek
  *
  * Parameters
  *   msg             : pointer to message buffer object
@@ -292,6 +315,7 @@ unsigned msg_waitFor( msg_t *msg, void *data, unsigned size, cnt_t delay );
  *
  * Description       : try to transfer data from the message buffer object,
  *                     wait until given timepoint while the message buffer object is empty
+ *                     or its first message is accessed by msg_peek
  *
  * Parameters
  *   msg             : pointer to message buffer object
@@ -313,6 +337,7 @@ unsigned msg_waitUntil( msg_t *msg, void *data, unsigned size, cnt_t time );
  *
  * Description       : try to transfer data from the message buffer object,
  *                     wait indefinitely while the message buffer object is empty
+ *                     or its first message is accessed by msg_peek
  *
  * Parameters
  *   msg             : pointer to message buffer object
@@ -465,6 +490,90 @@ unsigned msg_push( msg_t *msg, const void *data, unsigned size );
 __STATIC_INLINE
 unsigned msg_pushISR( msg_t *msg, const void *data, unsigned size ) { return msg_push(msg, data, size); }
 
+/******************************************************************************
+ *
+ * Name              : msg_reserve
+ *
+ * Description       : try to reserve space for a message of given size in the message buffer object,
+ *                     the message is written directly into the data buffer and then added with msg_commit
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   size            : size of the message
+ *   rgn             : pointer to region object, it gets the place of the reserved message in the data buffer
+ *
+ * Return            : size of the reserved message
+ *                     zero if there is not enough free space or another message is reserved
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     only one message can be reserved at a time; until it is committed,
+ *                     other producers can't transfer data to the data buffer (but they can pass messages
+ *                     directly to the waiting receivers) and the blocking ones wait for msg_commit
+ *
+ ******************************************************************************/
+
+unsigned msg_reserve( msg_t *msg, unsigned size, rgn_t *rgn );
+
+/******************************************************************************
+ *
+ * Name              : msg_commit
+ *
+ * Description       : add the message reserved by msg_reserve to the message buffer object
+ *                     and resume the tasks waiting for the message or for the end of the reservation
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   size            : size of the message (not greater than the reserved size), zero: cancel the reservation
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     the message is ignored if the message buffer object has been killed after the reservation
+ *
+ ******************************************************************************/
+
+void msg_commit( msg_t *msg, unsigned size );
+
+/******************************************************************************
+ *
+ * Name              : msg_peek
+ *
+ * Description       : try to access the first message in the message buffer object without copying,
+ *                     the message is read directly from the data buffer and then removed with msg_release
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   rgn             : pointer to region object, it gets the place of the first message in the data buffer
+ *
+ * Return            : size of the first message
+ *                     zero if the message buffer object is empty or the first message is already accessed
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     until the message is released, other consumers don't get any data from the message buffer,
+ *                     the blocking ones wait for msg_release
+ *
+ ******************************************************************************/
+
+unsigned msg_peek( msg_t *msg, rgn_t *rgn );
+
+/******************************************************************************
+ *
+ * Name              : msg_release
+ *
+ * Description       : remove the message accessed by msg_peek from the message buffer object,
+ *                     resume the tasks waiting for free space and the tasks waiting for the release
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void msg_release( msg_t *msg );
+
 /******************************************************************************
  *
  * Name              : msg_count
@@ -566,6 +675,10 @@ struct MessageBufferT : public __msg
 	unsigned giveISR  ( const void *_data, unsigned _size )               { return msg_giveISR  (this, _data, _size);         }
 	unsigned push     ( const void *_data, unsigned _size )               { return msg_push     (this, _data, _size);         }
 	unsigned pushISR  ( const void *_data, unsigned _size )               { return msg_pushISR  (this, _data, _size);         }
+	unsigned reserve  ( unsigned _size, rgn_t *_rgn )                     { return msg_reserve  (this, _size, _rgn);          }
+	void     commit   ( unsigned _size )                                  {        msg_commit   (this, _size);                }
+	unsigned peek     ( rgn_t *_rgn )                                     { return msg_peek     (this, _rgn);                 }
+	void     release  ( void )                                            {        msg_release  (this);                       }
 	unsigned count    ( void )                                            { return msg_count    (this);                       }
 	unsigned countISR ( void )                                            { return msg_countISR (this);                       }
 	unsigned space    ( void )                                            { return msg_space    (this);                       }
@@ -40,20 +40,21 @@ extern "C" {
 
 /******************************************************************************
  *
- * Name              : mutex (recursive, priority inheritance, robust)
+ * Name              : mutex (recursive, priority inheritance, priority ceiling, robust)
  *                     like a POSIX pthread_mutex_t
  *
  ******************************************************************************/
 
-typedef struct __mtx mtx_t, * const mtx_id;
-
 struct __mtx
 {
 	obj_t    obj;   // object header
 
 	tsk_t  * owner; // owner task
 	unsigned count; // mutex's curent value
+	unsigned ceil;  // priority ceiling (0: priority inheritance only)
 	mtx_t  * list;  // list of mutexes held by owner
+	mtx_t ** back;  // previous link in the list of mutexes held by owner
+	unsigned prio;  // priority inherited from the delayed queue
 };
 
 /******************************************************************************
@@ -62,7 +63,8 @@ struct __mtx
  *
  * Description       : create and initialize a mutex object
  *
- * Parameters        : none
+ * Parameters
+ *   ceiling         : priority ceiling of the mutex (0: priority inheritance only)
  *
  * Return            : mutex object
  *
@@ -70,7 +72,19 @@ struct __mtx
  *
  ******************************************************************************/
 
-#define               _MTX_INIT() { _OBJ_INIT(), 0, 0, 0 }
+#define               _MTX_INIT( _ceiling ) { _OBJ_INIT(), 0, 0, _ceiling, 0, 0, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _VA_MTX
+ *
+ * Description       : calculate priority ceiling of mutex from optional parameter
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _VA_MTX( _ceiling ) ( _ceiling + 0 )
 
 /******************************************************************************
  *
@@ -80,11 +94,14 @@ struct __mtx
  *
  * Parameters
  *   mtx             : name of a pointer to mutex object
+ *   ceiling         : (optional) priority ceiling of the mutex
+ *                     the owner of the mutex immediately gets the priority not less than the ceiling
+ *                     0: priority inheritance only (default)
  *
  ******************************************************************************/
 
-#define             OS_MTX( mtx )                     \
-                       mtx_t mtx##__mtx = _MTX_INIT(); \
+#define             OS_MTX( mtx, ... )                                      \
+                       mtx_t mtx##__mtx = _MTX_INIT( _VA_MTX(__VA_ARGS__) ); \
                        mtx_id mtx = & mtx##__mtx
 
 /******************************************************************************
@@ -95,11 +112,14 @@ struct __mtx
  *
  * Parameters
  *   mtx             : name of a pointer to mutex object
+ *   ceiling         : (optional) priority ceiling of the mutex
+ *                     the owner of the mutex immediately gets the priority not less than the ceiling
+ *                     0: priority inheritance only (default)
  *
  ******************************************************************************/
 
-#define         static_MTX( mtx )                     \
-                static mtx_t mtx##__mtx = _MTX_INIT(); \
+#define         static_MTX( mtx, ... )                                      \
+                static mtx_t mtx##__mtx = _MTX_INIT( _VA_MTX(__VA_ARGS__) ); \
                 static mtx_id mtx = & mtx##__mtx
 
 /******************************************************************************
@@ -108,7 +128,10 @@ struct __mtx
  *
  * Description       : create and initialize a mutex object
  *
- * Parameters        : none
+ * Parameters
+ *   ceiling         : (optional) priority ceiling of the mutex
+ *                     the owner of the mutex immediately gets the priority not less than the ceiling
+ *                     0: priority inheritance only (default)
  *
  * Return            : mutex object
  *
@@ -117,8 +140,8 @@ struct __mtx
  ******************************************************************************/
 
 #ifndef __cplusplus
-#define                MTX_INIT() \
-                      _MTX_INIT()
+#define                MTX_INIT( ... ) \
+                      _MTX_INIT( _VA_MTX(__VA_ARGS__) )
 #endif
 
 /******************************************************************************
@@ -128,7 +151,10 @@ struct __mtx
  *
  * Description       : create and initialize a mutex object
  *
- * Parameters        : none
+ * Parameters
+ *   ceiling         : (optional) priority ceiling of the mutex
+ *                     the owner of the mutex immediately gets the priority not less than the ceiling
+ *                     0: priority inheritance only (default)
  *
  * Return            : pointer to mutex object
  *
@@ -137,8 +163,8 @@ struct __mtx
  ******************************************************************************/
 
 #ifndef __cplusplus
-#define                MTX_CREATE() \
-           (mtx_t[]) { MTX_INIT  () }
+#define                MTX_CREATE( ... ) \
+           (mtx_t[]) { MTX_INIT  ( _VA_MTX(__VA_ARGS__) ) }
 #define                MTX_NEW \
                        MTX_CREATE
 #endif
@@ -151,6 +177,9 @@ struct __mtx
  *
  * Parameters
  *   mtx             : pointer to mutex object
+ *   ceiling         : priority ceiling of the mutex
+ *                     the owner of the mutex immediately gets the priority not less than the ceiling
+ *                     0: priority inheritance only
  *
  * Return            : none
  *
@@ -158,7 +187,7 @@ struct __mtx
  *
  ******************************************************************************/
 
-void mtx_init( mtx_t *mtx );
+void mtx_init( mtx_t *mtx, unsigned ceiling );
 
 /******************************************************************************
  *
@@ -167,7 +196,10 @@ void mtx_init( mtx_t *mtx );
  *
  * Description       : create and initialize a new mutex object
  *
- * Parameters        : none
+ * Parameters
+ *   ceiling         : priority ceiling of the mutex
+ *                     the owner of the mutex immediately gets the priority not less than the ceiling
+ *                     0: priority inheritance only
  *
  * Return            : pointer to mutex object (mutex successfully created)
  *   0               : mutex not created (not enough free memory)
@@ -176,10 +208,10 @@ void mtx_init( mtx_t *mtx );
  *
  ******************************************************************************/
 
-mtx_t *mtx_create( void );
+mtx_t *mtx_create( unsigned ceiling );
 
 __STATIC_INLINE
-mtx_t *mtx_new( void ) { return mtx_create(); }
+mtx_t *mtx_new( unsigned ceiling ) { return mtx_create(ceiling); }
 
 /******************************************************************************
  *
@@ -338,13 +370,15 @@ unsigned mtx_give( mtx_t *mtx );
  * Description       : create and initialize a mutex object
  *
  * Constructor parameters
- *                   : none
+ *   ceiling         : priority ceiling of the mutex
+ *                     the owner of the mutex immediately gets the priority not less than the ceiling
+ *                     0: priority inheritance only (default)
  *
  ******************************************************************************/
 
 struct Mutex : public __mtx
 {
-	 Mutex( void ): __mtx _MTX_INIT() {}
+	 Mutex( const unsigned _ceiling = 0 ): __mtx _MTX_INIT(_ceiling) {}
 	~Mutex( void ) { assert(__mtx::owner == nullptr); }
 
 	void     kill     ( void )         {        mtx_kill     (this);         }
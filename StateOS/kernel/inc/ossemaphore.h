@@ -448,6 +448,32 @@ unsigned sem_give( sem_t *sem );
 __STATIC_INLINE
 unsigned sem_giveISR( sem_t *sem ) { return sem_give(sem); }
 
+#if OS_ISR_QUEUE
+
+/******************************************************************************
+ *
+ * Name              : sem_giveAsync
+ *
+ * Description       : post sem_give request to the queue of deferred procedures,
+ *                     the request will be executed in the context switch handler
+ *                     the kernel lock isn't used
+ *
+ * Parameters
+ *   sem             : pointer to semaphore object
+ *
+ * Return
+ *   E_SUCCESS       : request was successfully posted
+ *   E_TIMEOUT       : queue of deferred procedures is full
+ *
+ * Note              : use only in handler mode
+ *                     result of the deferred sem_give procedure is lost
+ *
+ ******************************************************************************/
+
+unsigned sem_giveAsync( sem_t *sem );
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -487,6 +513,9 @@ struct Semaphore : public __sem
 	unsigned send     ( void )         { return sem_send     (this);         }
 	unsigned give     ( void )         { return sem_give     (this);         }
 	unsigned giveISR  ( void )         { return sem_giveISR  (this);         }
+#if OS_ISR_QUEUE
+	unsigned giveAsync( void )         { return sem_giveAsync(this);         }
+#endif
 };
 
 /******************************************************************************
@@ -360,6 +360,32 @@ void sig_give( sig_t *sig );
 __STATIC_INLINE
 void sig_giveISR( sig_t *sig ) { sig_give(sig); }
 
+#if OS_ISR_QUEUE
+
+/******************************************************************************
+ *
+ * Name              : sig_giveAsync
+ *
+ * Description       : post sig_give request to the queue of deferred procedures,
+ *                     the request will be executed in the context switch handler
+ *                     the kernel lock isn't used
+ *
+ * Parameters
+ *   sig             : pointer to signal object
+ *
+ * Return
+ *   E_SUCCESS       : request was successfully posted
+ *   E_TIMEOUT       : queue of deferred procedures is full
+ *
+ * Note              : use only in handler mode
+ *                     result of the deferred sig_give procedure is lost
+ *
+ ******************************************************************************/
+
+unsigned sig_giveAsync( sig_t *sig );
+
+#endif
+
 /******************************************************************************
  *
  * Name              : sig_clear
@@ -415,6 +441,9 @@ struct Signal : public __sig
 	unsigned takeISR  ( void )         { return sig_takeISR  (this);         }
 	void     give     ( void )         {        sig_give     (this);         }
 	void     giveISR  ( void )         {        sig_giveISR  (this);         }
+#if OS_ISR_QUEUE
+	unsigned giveAsync( void )         { return sig_giveAsync(this);         }
+#endif
 	void     clear    ( void )         {        sig_clear    (this);         }
 	void     clearISR ( void )         {        sig_clearISR (this);         }
 };
@@ -51,6 +51,15 @@ extern "C" {
 #define STK_CROP( base, size ) \
          LIMITED( (size_t)base + size, stk_t )
 
+// stack size of a task, not less than the minimal stack size required by the port
+
+#ifndef OS_STACK_MIN
+#define OS_STACK_MIN          0 /* no minimal stack size */
+#endif
+
+#define STK_MIN( size ) \
+       ( (size) > (OS_STACK_MIN) ? (size) : (OS_STACK_MIN) )
+
 /******************************************************************************
  *
  * Name              : task (thread)
@@ -65,8 +74,10 @@ struct __tsk
 	cnt_t    start; // inherited from timer
 	cnt_t    delay; // inherited from timer
 	cnt_t    slice;	// time slice
+	cnt_t    quant;	// length of time slice (in ticks), zero: (OS_FREQUENCY)/(OS_ROBIN)
 
 	tsk_t ** back;  // previous object in the DELAYED queue
+	tsk_t  * run;   // first / last task of the same priority in the DELAYED queue
 	stk_t  * stack; // base of stack
 	unsigned size;  // size of stack (in bytes)
 	void   * sp;    // current stack pointer
@@ -81,8 +92,28 @@ struct __tsk
 
 	struct {
 	mtx_t  * list;  // list of mutexes held
-	tsk_t  * tree;  // tree of tasks waiting for mutexes
+	mtx_t  * tree;  // mutex the task is waiting for
 	}        mtx;
+#if OS_EDF
+	struct {
+	cnt_t    dline; // relative deadline
+	cnt_t    due;   // absolute deadline
+	}        edf;
+	#define _TSK_EDF { 0, 0 },
+#else
+	#define _TSK_EDF
+#endif
+#if OS_CPU_STATS
+	struct {
+	uint64_t time;  // accumulated run time (in units of the time stamp counter)
+	uint64_t mark;  // run time at the previous load measurement
+	uint64_t base;  // total accounted time at the previous load measurement
+	unsigned count; // number of context switches to the task
+	}        cpu;
+	#define _TSK_CPU { 0, 0, 0, 0 },
+#else
+	#define _TSK_CPU
+#endif
 
 	union  {
 
@@ -165,7 +196,7 @@ struct __tsk
  ******************************************************************************/
 
 #define               _TSK_INIT( _prio, _state, _stack, _size ) \
-                       { _HDR_INIT(), _state, 0, 0, 0, 0, _stack, _size, 0, _prio, _prio, 0, 0, 0, { 0, 0 }, { { 0, 0 } }, _TSK_EXTRA }
+                       { _HDR_INIT(), _state, 0, 0, 0, 0, 0, 0, _stack, _size, 0, _prio, _prio, 0, 0, 0, { 0, 0 }, _TSK_EDF _TSK_CPU { { 0, 0 } }, _TSK_EXTRA }
 
 /******************************************************************************
  *
@@ -207,7 +238,7 @@ struct __tsk
  ******************************************************************************/
 
 #ifndef __cplusplus
-#define               _TSK_STACK( _size ) (stk_t[STK_SIZE(_size)]){ 0 }
+#define               _TSK_STACK( _size ) (stk_t[STK_SIZE(STK_MIN(_size))]){ 0 }
 #endif
 
 /******************************************************************************
@@ -238,8 +269,8 @@ struct __tsk
  ******************************************************************************/
 
 #define             OS_WRK( tsk, prio, state, size )                                \
-                       stk_t tsk##__stk[STK_SIZE( size )];                           \
-                       tsk_t tsk##__tsk = _TSK_INIT( prio, state, tsk##__stk, size ); \
+                       stk_t tsk##__stk[STK_SIZE( STK_MIN( size ) )];                \
+                       tsk_t tsk##__tsk = _TSK_INIT( prio, state, tsk##__stk, STK_MIN( size ) ); \
                        tsk_id tsk = & tsk##__tsk
 
 /******************************************************************************
@@ -353,8 +384,8 @@ struct __tsk
  ******************************************************************************/
 
 #define         static_WRK( tsk, prio, state, size )                                \
-                static stk_t tsk##__stk[STK_SIZE( size )];                           \
-                static tsk_t tsk##__tsk = _TSK_INIT( prio, state, tsk##__stk, size ); \
+                static stk_t tsk##__stk[STK_SIZE( STK_MIN( size ) )];                \
+                static tsk_t tsk##__tsk = _TSK_INIT( prio, state, tsk##__stk, STK_MIN( size ) ); \
                 static tsk_id tsk = & tsk##__tsk
 
 /******************************************************************************
@@ -472,7 +503,7 @@ struct __tsk
 
 #ifndef __cplusplus
 #define                WRK_INIT( prio, state, size ) \
-                      _TSK_INIT( prio, state, _TSK_STACK( size ), size )
+                      _TSK_INIT( prio, state, _TSK_STACK( size ), STK_MIN( size ) )
 #endif
 
 /******************************************************************************
@@ -584,6 +615,7 @@ tsk_t *tsk_this( void ) { return System.cur; }
  * Return            : task object
  *
  * Note              : use only in thread mode
+ *                     size of the stack mustn't be less than OS_STACK_MIN (the minimal stack size of the port)
  *
  ******************************************************************************/
 
@@ -600,7 +632,7 @@ void tsk_init( tsk_t *tsk, unsigned prio, fun_t *state, stk_t *stack, unsigned s
  *   prio            : initial task priority (any unsigned int value)
  *   state           : task state (initial task function) doesn't have to be noreturn-type
  *                     it will be executed into an infinite system-implemented loop
- *   size            : size of task private stack (in bytes)
+ *   size            : size of task private stack (in bytes), enlarged to OS_STACK_MIN if smaller
  *
  * Return            : pointer to task object (task successfully created)
  *   0               : task not created (not enough free memory)
@@ -843,6 +875,173 @@ void tsk_setPrio( unsigned prio ) { tsk_prio(prio); }
 __STATIC_INLINE
 unsigned tsk_getPrio( void ) { return System.cur->basic; }
 
+/******************************************************************************
+ *
+ * Name              : tsk_setQuantum
+ *
+ * Description       : set length of time slice of the task (preemptive mode)
+ *                     the task is preempted by the next task of the same priority after its time slice expires
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   quantum         : length of time slice (in ticks), zero: default length (OS_FREQUENCY)/(OS_ROBIN)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     in tick-less mode the new length is used from the next context switch
+ *
+ ******************************************************************************/
+
+void tsk_setQuantum( tsk_t *tsk, cnt_t quantum );
+
+#if OS_CPU_STATS
+
+/******************************************************************************
+ *
+ * Name              : tsk_getLoad
+ *
+ * Description       : get CPU load of the task since the previous call of tsk_getLoad for the task (OS_CPU_STATS mode)
+ *                     called periodically, it gives the load over a sliding window
+ *                     use IDLE task to get the idle time
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : CPU load in per mille (0..1000)
+ *
+ * Note              : use only in thread mode
+ *                     the window is kept in the task object and every call starts a new one,
+ *                     so only one monitor may call tsk_getLoad for the task,
+ *                     other monitors should compare the results of tsk_getTime
+ *
+ ******************************************************************************/
+
+unsigned tsk_getLoad( tsk_t *tsk );
+
+/******************************************************************************
+ *
+ * Name              : tsk_getTime
+ *
+ * Description       : get accumulated run time of the task (OS_CPU_STATS mode)
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : run time in processor cycles (Cortex-M3 and later) or in ticks of system timer
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+uint64_t tsk_getTime( tsk_t *tsk );
+
+/******************************************************************************
+ *
+ * Name              : tsk_getSwitches
+ *
+ * Description       : get number of context switches to the task (OS_CPU_STATS mode)
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : number of context switches
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned tsk_getSwitches( tsk_t *tsk ) { return tsk->cpu.count; }
+
+#endif
+
+#if OS_STACK_STATS
+
+/******************************************************************************
+ *
+ * Name              : tsk_getStackUsed
+ *
+ * Description       : get the high-water mark of the stack of the task (OS_STACK_STATS mode)
+ *                     use IDLE task to get the high-water mark of the stack of the idle task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : maximum number of bytes of the stack ever used since the task was started
+ *                     zero for the main task (size of its stack is unknown)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned tsk_getStackUsed( tsk_t *tsk ) { return core_stk_used(tsk->stack, tsk->size); }
+
+/******************************************************************************
+ *
+ * Name              : tsk_stackReport
+ *
+ * Description       : call procedure 'report' for every task in the ready or delayed state (including IDLE)
+ *                     with the high-water mark of its stack (OS_STACK_STATS mode)
+ *
+ * Parameters
+ *   report          : procedure called with pointer to task object and the high-water mark of its stack (in bytes)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     procedure 'report' is called without the kernel lock,
+ *                     a task changing its state during the report may be skipped or reported twice
+ *
+ ******************************************************************************/
+
+void tsk_stackReport( void (*report)( tsk_t *tsk, unsigned used ) );
+
+#endif
+
+#if OS_EDF
+
+/******************************************************************************
+ *
+ * Name              : tsk_setDeadline
+ *
+ * Description       : set relative deadline of the current task (OS_EDF mode)
+ *                     the absolute deadline is counted from the current time point
+ *                     and then from every start / resume of the task
+ *                     tasks of the same priority are scheduled in order of their absolute deadlines
+ *
+ * Parameters
+ *   deadline        : relative deadline (in ticks), zero: the task is scheduled after the tasks with a deadline
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     may cause a context switch
+ *
+ ******************************************************************************/
+
+void tsk_setDeadline( cnt_t deadline );
+
+/******************************************************************************
+ *
+ * Name              : tsk_getDeadline
+ *
+ * Description       : get absolute deadline of the current task (OS_EDF mode)
+ *
+ * Parameters        : none
+ *
+ * Return            : absolute deadline of the current task
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+cnt_t tsk_getDeadline( void ) { return System.cur->edf.due; }
+
+#endif
+
 /******************************************************************************
  *
  * Name              : tsk_waitFor
@@ -934,6 +1133,33 @@ unsigned tsk_give( tsk_t *tsk, unsigned flags );
 __STATIC_INLINE
 unsigned tsk_giveISR( tsk_t *tsk, unsigned flags ) { return tsk_give(tsk, flags); }
 
+#if OS_ISR_QUEUE
+
+/******************************************************************************
+ *
+ * Name              : tsk_giveAsync
+ *
+ * Description       : post tsk_give request to the queue of deferred procedures,
+ *                     the request will be executed in the context switch handler
+ *                     the kernel lock isn't used
+ *
+ * Parameters
+ *   tsk             : pointer to delayed task object
+ *   flags           : flags or event to be transferred to the task
+ *
+ * Return
+ *   E_SUCCESS       : request was successfully posted
+ *   E_TIMEOUT       : queue of deferred procedures is full
+ *
+ * Note              : use only in handler mode
+ *                     result of the deferred tsk_give procedure is lost
+ *
+ ******************************************************************************/
+
+unsigned tsk_giveAsync( tsk_t *tsk, unsigned flags );
+
+#endif
+
 /******************************************************************************
  *
  * Name              : tsk_sleepFor
@@ -1084,7 +1310,7 @@ unsigned tsk_resumeISR( tsk_t *tsk ) { return tsk_resume(tsk); }
 template<unsigned size_ = OS_STACK_SIZE>
 struct staticTaskT : public __tsk
 {
-	 staticTaskT( const unsigned _prio, fun_t *_state ): __tsk _TSK_INIT(_prio, _state, stack_, size_) {}
+	 staticTaskT( const unsigned _prio, fun_t *_state ): __tsk _TSK_INIT(_prio, _state, stack_, STK_MIN(size_)) {}
 	~staticTaskT( void ) { assert(__tsk::hdr.id == ID_STOPPED); }
 
 	void     kill     ( void )            {        tsk_kill      (this);         }
@@ -1094,16 +1320,28 @@ struct staticTaskT : public __tsk
 	void     startFrom( fun_t  * _state ) {        tsk_startFrom (this, _state); }
 	unsigned give     ( unsigned _flags ) { return tsk_give      (this, _flags); }
 	unsigned giveISR  ( unsigned _flags ) { return tsk_giveISR   (this, _flags); }
+#if OS_ISR_QUEUE
+	unsigned giveAsync( unsigned _flags ) { return tsk_giveAsync (this, _flags); }
+#endif
 	unsigned suspend  ( void )            { return tsk_suspend   (this);         }
 	unsigned resume   ( void )            { return tsk_resume    (this);         }
 	unsigned resumeISR( void )            { return tsk_resumeISR (this);         }
 
 	unsigned prio     ( void )            { return __tsk::basic;                 }
 	unsigned getPrio  ( void )            { return __tsk::basic;                 }
+	void     setQuantum( cnt_t _quantum ) {        tsk_setQuantum(this, _quantum); }
+#if OS_CPU_STATS
+	unsigned getLoad  ( void )            { return tsk_getLoad   (this);         }
+	uint64_t getTime  ( void )            { return tsk_getTime   (this);         }
+	unsigned getSwitches( void )          { return tsk_getSwitches(this);        }
+#endif
+#if OS_STACK_STATS
+	unsigned getStackUsed( void )         { return tsk_getStackUsed(this);       }
+#endif
 	bool     operator!( void )            { return __tsk::hdr.id == ID_STOPPED;  }
 
 	private:
-	stk_t stack_[STK_SIZE(size_)];
+	stk_t stack_[STK_SIZE(STK_MIN(size_))];
 };
 
 /* -------------------------------------------------------------------------- */
@@ -1191,6 +1429,11 @@ namespace ThisTask
 	static inline void     setPrio   ( unsigned _prio )                {        tsk_setPrio   (_prio);                 }
 	static inline unsigned getPrio   ( void )                          { return tsk_getPrio   ();                      }
 	static inline unsigned prio      ( void )                          { return tsk_getPrio   ();                      }
+	static inline void     setQuantum( cnt_t    _quantum )             {        tsk_setQuantum(System.cur, _quantum);  }
+#if OS_EDF
+	static inline void     setDeadline( cnt_t _deadline )              {        tsk_setDeadline(_deadline);            }
+	static inline cnt_t    getDeadline( void )                         { return tsk_getDeadline();                     }
+#endif
 
 	static inline void     kill      ( void )                          {        tsk_kill      (System.cur);            }
 	static inline unsigned detach    ( void )                          { return tsk_detach    (System.cur);            }
@@ -47,4 +47,60 @@ cnt_t sys_time( void )
 	return cnt;
 }
 
+#if OS_STACK_STATS
+
+/* -------------------------------------------------------------------------- */
+unsigned sys_getStackUsed( void )
+/* -------------------------------------------------------------------------- */
+{
+#ifdef ISR_STACK
+	return core_stk_used(ISR_STACK, ISR_STACK_SIZE);
+#else
+	return 0;
+#endif
+}
+
+#endif
+
+#if OS_LOCK_STATS
+
+/* -------------------------------------------------------------------------- */
+uint64_t sys_getLockTime( void )
+/* -------------------------------------------------------------------------- */
+{
+	uint64_t time;
+
+	sys_lock();
+	{
+		time = System.lck.time;
+	}
+	sys_unlock();
+
+	return time;
+}
+
+/* -------------------------------------------------------------------------- */
+void sys_lockReport( void (*report)( lcs_t *lcs ) )
+/* -------------------------------------------------------------------------- */
+{
+	lcs_t *lcs, tmp;
+
+	assert(!port_isr_context());
+	assert(report);
+
+	// call sites are only prepended to the list, so the list can be traversed without the kernel lock
+	for (lcs = System.lck.list; lcs; lcs = lcs->next)
+	{
+		sys_lock();
+		{
+			tmp = *lcs;
+		}
+		sys_unlock();
+
+		report(&tmp);
+	}
+}
+
+#endif
+
 /* -------------------------------------------------------------------------- */
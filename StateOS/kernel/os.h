@@ -108,6 +108,86 @@ cnt_t sys_time( void );
 __STATIC_INLINE
 cnt_t sys_timeISR( void ) { return sys_time(); }
 
+#if OS_STACK_STATS
+
+/******************************************************************************
+ *
+ * Name              : sys_getStackUsed
+ *
+ * Description       : get the high-water mark of the stack of interrupt handlers (OS_STACK_STATS mode)
+ *
+ * Parameters        : none
+ *
+ * Return            : maximum number of bytes of the stack ever used
+ *                     zero if the port doesn't separate the stack of interrupt handlers from the stack of the main task
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned sys_getStackUsed( void );
+
+/******************************************************************************
+ *
+ * Name              : sys_getStackFault
+ *
+ * Description       : get the first task, which damaged the guard band at the bottom of its stack (OS_STACK_STATS mode)
+ *                     the guard band of the preempted task is checked at every context switch
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to task object or zero if no damage has been found
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+tsk_t *sys_getStackFault( void ) { return System.stk; }
+
+#endif
+
+#if OS_LOCK_STATS
+
+/******************************************************************************
+ *
+ * Name              : sys_getLockTime
+ *
+ * Description       : get the total time of the kernel lock windows (OS_LOCK_STATS mode)
+ *
+ * Parameters        : none
+ *
+ * Return            : total time with the kernel lock set (in counts of the time stamp counter, CPU_TIME_FREQUENCY)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+uint64_t sys_getLockTime( void );
+
+/******************************************************************************
+ *
+ * Name              : sys_lockReport
+ *
+ * Description       : call procedure 'report' for every call site with measured kernel lock windows (OS_LOCK_STATS mode)
+ *                     the statistics contain source file and line of the call site, number of windows,
+ *                     the longest window, total time of windows and histogram of lengths of windows (LCK_BINS bins)
+ *
+ * Parameters
+ *   report          : procedure called with pointer to a copy of statistics of the call site
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     procedure 'report' is called without the kernel lock and may use system services
+ *                     lengths of windows are given in counts of the time stamp counter (CPU_TIME_FREQUENCY)
+ *
+ ******************************************************************************/
+
+void sys_lockReport( void (*report)( lcs_t *lcs ) );
+
+#endif
+
 /******************************************************************************
  *
  * Name              : stk_assert
@@ -36,7 +36,47 @@
 // SYSTEM ALLOC/FREE SERVICES
 /* -------------------------------------------------------------------------- */
 
-#if OS_HEAP_SIZE
+#if OS_HEAP_STATS
+
+// counters of the heap, updated by sys_alloc and sys_free
+// 'largest' and 'segs' are filled in by sys_heapStats (first fit) or kept by the free lists (TLSF)
+
+static
+hst_t Stats;
+
+static
+void priv_hst_alloc( size_t size )
+{
+	Stats.allocs++;
+	Stats.used += size;
+	if (Stats.peak < Stats.used)
+		Stats.peak = Stats.used;
+}
+
+static
+void priv_hst_free( size_t size )
+{
+	Stats.frees++;
+	Stats.used -= size;
+}
+
+static
+void priv_hst_fail( void )
+{
+	Stats.fails++;
+}
+
+#else
+
+#define priv_hst_alloc( size ) ((void)0)
+#define priv_hst_free( size )  ((void)0)
+#define priv_hst_fail()        ((void)0)
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_HEAP_SIZE && OS_HEAP_TLSF == 0
 
 static
 seg_t Heap[SEG_SIZE(OS_HEAP_SIZE)+1] =
@@ -81,8 +121,12 @@ void *sys_alloc( size_t size )
 			mem->next = nxt;
 			mem = mem + 1;
 		//	memory segment has been successfully allocated
+			priv_hst_alloc(size * sizeof(seg_t));
 			break;
 		}
+
+		if (mem == 0)
+			priv_hst_fail();
 	}
 	sys_unlock();
 
@@ -108,12 +152,403 @@ void sys_free( void *base )
 
 			mem->owner = mem;
 		//	memory segment has been successfully released
+			priv_hst_free((size_t)(mem->next - mem) * sizeof(seg_t));
 			break;
 		}
 	}
 	sys_unlock();
 }
 
+/* -------------------------------------------------------------------------- */
+
+#if OS_HEAP_STATS
+
+void sys_heapStats( hst_t *hst )
+{
+	seg_t *mem;
+	size_t cnt;
+
+	assert(hst);
+
+	sys_lock();
+	{
+		*hst = Stats;
+		hst->size    = SEG_SIZE(OS_HEAP_SIZE) * sizeof(seg_t);
+		hst->largest = 0;
+		hst->segs    = 0;
+
+		for (mem = Heap; mem; mem = mem->next)
+		{
+			if (mem->owner == 0)
+		//	memory segment has been allocated
+				continue;
+
+		//	adjacent free memory segments are counted as one (they are merged by sys_alloc)
+			for (cnt = 0; mem->next && mem->next->owner; mem = mem->next)
+				cnt += (size_t)(mem->next - mem);
+			cnt += (size_t)(mem->next - mem);
+
+			if (hst->largest < cnt * sizeof(seg_t))
+				hst->largest = cnt * sizeof(seg_t);
+			hst->segs++;
+		}
+	}
+	sys_unlock();
+}
+
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_HEAP_SIZE && OS_HEAP_TLSF
+
+// size of the heap in seg_t units
+#define HEAP_UNITS     SEG_SIZE(OS_HEAP_SIZE)
+
+// floor(log2(n)) of a constant n, 0 < n < 2^32
+#define LOG2_4( n )  (((n) >= 0x2UL)   ? (((n) >= 0x8UL)    ?  3 :  (((n) >= 0x4UL)   ?  2 : 1)) : 0)
+#define LOG2_8( n )  (((n) >= 0x10UL)  ? (4  + LOG2_4 ((n) >>  4)) : LOG2_4 (n))
+#define LOG2_16( n ) (((n) >= 0x100UL) ? (8  + LOG2_8 ((n) >>  8)) : LOG2_8 (n))
+#define LOG2_32( n ) (((n) >= 0x10000UL)?(16 + LOG2_16((n) >> 16)) : LOG2_16(n))
+
+// every first level list (power of two range of sizes) is divided into SL_COUNT second level lists
+#define SL_LOG2        4
+#define SL_COUNT      (1 << SL_LOG2)
+// the first level list 0 holds blocks smaller than SL_COUNT units, one unit per second level list
+#define FL_COUNT      (LOG2_32(HEAP_UNITS) >= SL_LOG2 ? LOG2_32(HEAP_UNITS) - SL_LOG2 + 2 : 1)
+
+// block is free (bit 0 of the block size)
+#define BLK_FREE       1U
+
+/******************************************************************************
+ *
+ * Name              : memory block header
+ *
+ ******************************************************************************/
+
+typedef struct __blk blk_t;
+
+struct __blk
+{
+	blk_t  * prev;  // previous block in the heap (physically), zero for the first block
+	size_t   size;  // size of the block in bytes (with the header), bit 0: the block is free
+	// fields below are valid only in free blocks
+	blk_t  * next_free; // next block in the free list
+	blk_t  * prev_free; // previous block in the free list
+};
+
+// the header of allocated block (prev and size fields) takes one seg_t unit
+
+static
+union { seg_t seg[HEAP_UNITS]; blk_t blk; } Heap;
+
+static
+blk_t  * Free[FL_COUNT][SL_COUNT];
+
+static
+uint32_t FLmap;
+
+static
+uint32_t SLmap[FL_COUNT];
+
+/* -------------------------------------------------------------------------- */
+// return the index of the most significant bit set in 'map' (map != 0)
+
+static
+unsigned priv_map_fls( uint32_t map )
+{
+	return 31 - core_map_clz(map);
+}
+
+/* -------------------------------------------------------------------------- */
+// return the index of the least significant bit set in 'map' (map != 0)
+
+static
+unsigned priv_map_ffs( uint32_t map )
+{
+	return priv_map_fls(map & (~map + 1));
+}
+
+/* -------------------------------------------------------------------------- */
+// return the list indexes 'fl', 'sl' for the block of size 'cnt' (in seg_t units)
+
+static
+void priv_blk_map( size_t cnt, unsigned *fl, unsigned *sl )
+{
+	unsigned idx;
+
+	if (cnt < SL_COUNT)
+	{
+		*fl = 0;
+		*sl = (unsigned) cnt;
+	}
+	else
+	{
+		idx = priv_map_fls((uint32_t) cnt);
+		*fl = idx - SL_LOG2 + 1;
+		*sl = (unsigned)(cnt >> (idx - SL_LOG2)) - SL_COUNT;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+size_t priv_blk_units( blk_t *blk )
+{
+	return (blk->size & ~(size_t)BLK_FREE) / sizeof(seg_t);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+blk_t *priv_blk_next( blk_t *blk )
+{
+	return (blk_t *)((seg_t *)blk + priv_blk_units(blk));
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_blk_insert( blk_t *blk )
+{
+	unsigned fl, sl;
+
+	priv_blk_map(priv_blk_units(blk), &fl, &sl);
+
+	blk->size |= BLK_FREE;
+#if OS_HEAP_STATS
+	Stats.segs++;
+#endif
+	blk->prev_free = 0;
+	blk->next_free = Free[fl][sl];
+	if (blk->next_free)
+		blk->next_free->prev_free = blk;
+	Free[fl][sl] = blk;
+
+	FLmap     |= 1UL << fl;
+	SLmap[fl] |= 1UL << sl;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_blk_remove( blk_t *blk )
+{
+	unsigned fl, sl;
+
+	priv_blk_map(priv_blk_units(blk), &fl, &sl);
+
+	blk->size &= ~(size_t)BLK_FREE;
+#if OS_HEAP_STATS
+	Stats.segs--;
+#endif
+	if (blk->next_free)
+		blk->next_free->prev_free = blk->prev_free;
+	if (blk->prev_free)
+		blk->prev_free->next_free = blk->next_free;
+	else
+	if ((Free[fl][sl] = blk->next_free) == 0)
+	{
+		SLmap[fl] &= ~(1UL << sl);
+		if (SLmap[fl] == 0)
+			FLmap &= ~(1UL << fl);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+// find a free block of at least 'cnt' units; the size is rounded up to the next list,
+// so any block of the list found is large enough (good fit);
+// if there is no such block, the first block of the list of the size itself is checked
+
+static
+blk_t *priv_blk_find( size_t cnt )
+{
+	unsigned fl, sl;
+	uint32_t map;
+	size_t   req = cnt;
+
+	if (cnt >= SL_COUNT)
+		cnt += ((size_t)1 << (priv_map_fls((uint32_t) cnt) - SL_LOG2)) - 1;
+
+	if (cnt < HEAP_UNITS)
+	{
+		priv_blk_map(cnt, &fl, &sl);
+
+		map = SLmap[fl] & (~0UL << sl);
+		if (map == 0)
+		{
+			map = FLmap & (~0UL << fl << 1);
+			if (map)
+			{
+				fl = priv_map_ffs(map);
+				map = SLmap[fl];
+			}
+		}
+		if (map)
+			return Free[fl][priv_map_ffs(map)];
+	}
+
+	if (req >= HEAP_UNITS)
+		return 0;
+
+	priv_blk_map(req, &fl, &sl);
+
+	if (Free[fl][sl] && priv_blk_units(Free[fl][sl]) >= req)
+		return Free[fl][sl];
+
+	return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+// the heap is a single free block followed by the sentinel (allocated block of zero size)
+
+static
+void priv_heap_init( void )
+{
+	blk_t *blk = &Heap.blk;
+	blk_t *end = (blk_t *)(Heap.seg + HEAP_UNITS - SEG_SIZE(sizeof(blk_t)));
+
+	blk->prev = 0;
+	blk->size = (HEAP_UNITS - SEG_SIZE(sizeof(blk_t))) * sizeof(seg_t);
+	end->prev = blk;
+	end->size = 0;
+
+	priv_blk_insert(blk);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void *sys_alloc( size_t size )
+{
+	blk_t *blk;
+	blk_t *nxt;
+	size_t cnt;
+
+	assert(SEG_SIZE(size));
+
+	cnt = SEG_SIZE(size) + 1;
+	if (cnt < SEG_SIZE(sizeof(blk_t)))
+		cnt = SEG_SIZE(sizeof(blk_t));
+
+	sys_lock();
+	{
+		if (Heap.blk.size == 0)
+		//	the heap hasn't been initialized yet
+			priv_heap_init();
+
+		blk = priv_blk_find(cnt);
+
+		if (blk)
+		{
+			priv_blk_remove(blk);
+
+			if (priv_blk_units(blk) >= cnt + SEG_SIZE(sizeof(blk_t)))
+		//	memory block is larger than required, the rest is returned to the free lists
+			{
+				nxt = (blk_t *)((seg_t *)blk + cnt);
+				nxt->prev = blk;
+				nxt->size = blk->size - cnt * sizeof(seg_t);
+				priv_blk_next(nxt)->prev = nxt;
+				blk->size = cnt * sizeof(seg_t);
+				priv_blk_insert(nxt);
+			}
+
+			priv_hst_alloc(blk->size);
+		}
+		else
+		{
+			priv_hst_fail();
+		}
+	}
+	sys_unlock();
+
+	assert(blk);
+
+	if (blk == 0)
+		return 0;
+
+	//	memory block has been successfully allocated, it is cleared outside the critical section
+	return memset((seg_t *)blk + 1, 0, (priv_blk_units(blk) - 1) * sizeof(seg_t));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sys_free( void *base )
+{
+	blk_t *blk;
+	blk_t *nxt;
+
+	if (base == 0)
+		return;
+
+	blk = (blk_t *)((seg_t *)base - 1);
+
+	sys_lock();
+	{
+		assert((blk->size & BLK_FREE) == 0);
+
+		priv_hst_free(blk->size);
+
+		nxt = priv_blk_next(blk);
+		if (nxt->size & BLK_FREE)
+		//	merge with the next free block
+		{
+			priv_blk_remove(nxt);
+			blk->size += nxt->size;
+		}
+
+		nxt = blk->prev;
+		if (nxt && (nxt->size & BLK_FREE))
+		//	merge with the previous free block
+		{
+			priv_blk_remove(nxt);
+			nxt->size += blk->size;
+			blk = nxt;
+		}
+
+		priv_blk_next(blk)->prev = blk;
+		priv_blk_insert(blk);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_HEAP_STATS
+
+void sys_heapStats( hst_t *hst )
+{
+	blk_t *blk;
+	unsigned fl;
+
+	assert(hst);
+
+	sys_lock();
+	{
+		if (Heap.blk.size == 0)
+		//	the heap hasn't been initialized yet
+			priv_heap_init();
+
+		*hst = Stats;
+		hst->size    = (HEAP_UNITS - SEG_SIZE(sizeof(blk_t))) * sizeof(seg_t);
+		hst->largest = 0;
+
+		if (FLmap)
+		//	the largest free block is in the highest non-empty list
+		{
+			fl = priv_map_fls(FLmap);
+			for (blk = Free[fl][priv_map_fls(SLmap[fl])]; blk; blk = blk->next_free)
+				if (hst->largest < (blk->size & ~(size_t)BLK_FREE))
+					hst->largest = blk->size & ~(size_t)BLK_FREE;
+		}
+	}
+	sys_unlock();
+}
+
+#endif
+
 #endif
 
 /* -------------------------------------------------------------------------- */
@@ -129,7 +564,14 @@ void *sys_alloc( size_t size )
 	mem = malloc(size);
 
 	if (mem)
+	{
 		mem = memset(mem, 0, size);
+		priv_hst_alloc(0);
+	}
+	else
+	{
+		priv_hst_fail();
+	}
 
 	assert(mem);
 
@@ -140,9 +582,101 @@ void *sys_alloc( size_t size )
 
 void sys_free( void *base )
 {
+	if (base)
+		priv_hst_free(0);
+
 	free(base);
 }
 
+/* -------------------------------------------------------------------------- */
+
+#if OS_HEAP_STATS
+
+void sys_heapStats( hst_t *hst )
+{
+	assert(hst);
+
+	sys_lock();
+	{
+		*hst = Stats;
+	}
+	sys_unlock();
+}
+
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_SLAB_SIZE
+
+// the header of an allocated slot: 'next' is zero, 'owner' points to the slab cache
+// the header of a free slot: 'next' links the free slots of the cache
+
+void *sys_slabAlloc( slb_t *slb )
+{
+	seg_t  * seg;
+	unsigned cnt;
+
+	assert(slb);
+	assert(slb->size > 1);
+
+	sys_lock();
+	{
+		if (slb->free == 0)
+		//	the cache is empty, it grows by a chunk of slots
+		{
+			seg = sys_alloc(OS_SLAB_SIZE * slb->size * sizeof(seg_t));
+			for (cnt = OS_SLAB_SIZE; seg && cnt; cnt--, seg += slb->size)
+			{
+				seg->next = slb->free;
+				slb->free = seg;
+			}
+		}
+
+		seg = slb->free;
+
+		if (seg)
+		{
+			slb->free  = seg->next;
+			seg->next  = 0;
+			seg->owner = (seg_t *) slb;
+			seg = memset(seg + 1, 0, (slb->size - 1) * sizeof(seg_t));
+		}
+	}
+	sys_unlock();
+
+	assert(seg);
+
+	return seg;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sys_slabFree( obj_t *obj )
+{
+	seg_t *seg = obj->res;
+	slb_t *slb;
+
+	sys_lock();
+	{
+		if (seg != 0 && seg + 1 == (seg_t *) obj)
+		//	the object has been allocated with sys_slabAlloc
+		{
+			slb = (slb_t *) seg->owner;
+			seg->owner = 0;
+			seg->next  = slb->free;
+			slb->free  = seg;
+		}
+		else
+		{
+			sys_free(seg);
+		}
+	}
+	sys_unlock();
+}
+
 #endif
 
 /* -------------------------------------------------------------------------- */
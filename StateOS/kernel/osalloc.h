@@ -95,6 +95,148 @@ void *sys_alloc( size_t size );
 
 void sys_free( void *ptr );
 
+/******************************************************************************
+ *
+ * Name              : slab cache
+ *
+ ******************************************************************************/
+
+typedef struct __slb slb_t;
+
+struct __slb
+{
+	seg_t  * free;  // list of free slots
+	unsigned size;  // size of a slot (in seg_t units, with the header)
+};
+
+/******************************************************************************
+ *
+ * Name              : _SLB_INIT
+ *
+ * Description       : create and initialize a slab cache object
+ *
+ * Parameters
+ *   size            : size of objects of the cache (in bytes)
+ *
+ * Return            : slab cache object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _SLB_INIT( _size ) { 0, SEG_SIZE(_size) + 1 }
+
+/******************************************************************************
+ *
+ * Name              : SLB_RES
+ *
+ * Description       : return the resource of an object allocated with sys_slabAlloc
+ *
+ * Parameters
+ *   obj             : pointer to the object
+ *
+ * Return            : value for the 'res' field of the object header
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#if OS_SLAB_SIZE
+#define                SLB_RES( obj ) (void *)((seg_t *)( obj ) - 1)
+#else
+#define                SLB_RES( obj ) (void *)( obj )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_slabAlloc
+ *
+ * Description       : allocate a cleared slot of the slab cache,
+ *                     if the cache is empty, it grows by OS_SLAB_SIZE slots allocated with sys_alloc
+ *
+ * Parameters
+ *   slb             : pointer to slab cache object
+ *
+ * Return            : pointer to the beginning of allocated and cleared slot
+ *   0               : slot not allocated (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *                     if OS_SLAB_SIZE == 0, the memory is allocated with sys_alloc
+ *
+ ******************************************************************************/
+
+#if OS_SLAB_SIZE
+void *sys_slabAlloc( slb_t *slb );
+#else
+__STATIC_INLINE
+void *sys_slabAlloc( slb_t *slb ) { return sys_alloc((slb->size - 1) * sizeof(seg_t)); }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_slabFree
+ *
+ * Description       : release the resource of the object,
+ *                     a slot allocated with sys_slabAlloc is returned to its cache, other resources are released with sys_free
+ *
+ * Parameters
+ *   obj             : pointer to the object header, the 'res' field is the resource
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     a slot is recognized by its resource (SLB_RES), it precedes the object
+ *
+ ******************************************************************************/
+
+#if OS_SLAB_SIZE
+void sys_slabFree( obj_t *obj );
+#else
+__STATIC_INLINE
+void sys_slabFree( obj_t *obj ) { sys_free(obj->res); }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : heap statistics
+ *
+ ******************************************************************************/
+
+typedef struct __hst hst_t;
+
+struct __hst
+{
+	size_t   size;    // size of the system heap (in bytes, 0 if the heap is provided by malloc)
+	size_t   used;    // memory used by allocated blocks (in bytes, with the headers)
+	size_t   peak;    // high-water mark of the used memory
+	size_t   largest; // size of the largest free block (in bytes, with the header)
+	unsigned segs;    // number of free blocks
+	unsigned allocs;  // number of successful allocations
+	unsigned frees;   // number of releases
+	unsigned fails;   // number of failed allocations
+};
+
+/******************************************************************************
+ *
+ * Name              : sys_heapStats
+ *
+ * Description       : get statistics of the system heap
+ *
+ * Parameters
+ *   hst             : pointer to the structure to be filled with the statistics
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     available only if OS_HEAP_STATS is set
+ *                     if OS_HEAP_SIZE == 0, only the counters are collected
+ *
+ ******************************************************************************/
+
+#if OS_HEAP_STATS
+void sys_heapStats( hst_t *hst );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
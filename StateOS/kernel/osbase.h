@@ -69,8 +69,80 @@ typedef uint64_t     cnt_t;
 
 /* -------------------------------------------------------------------------- */
 
+#ifndef OS_PRIO_LEVELS
+#define OS_PRIO_LEVELS        0 /* tasks' READY queue is a priority sorted list */
+#endif
+
+#if     OS_PRIO_LEVELS > 32
+#error  osconfig.h: Incorrect OS_PRIO_LEVELS value! Must be less then or equal to 32.
+#endif
+
+#ifndef OS_EDF
+#define OS_EDF                0 /* tasks of the same priority are scheduled in fifo order */
+#endif
+
+#ifndef OS_TICKLESS_IDLE
+#define OS_TICKLESS_IDLE      0 /* system timer generates all ticks when idle */
+#endif
+
+#ifndef OS_ISR_QUEUE
+#define OS_ISR_QUEUE          0 /* no queue of procedures deferred by interrupt handlers */
+#endif
+
+#if     OS_ISR_QUEUE & (OS_ISR_QUEUE - 1)
+#error  osconfig.h: Incorrect OS_ISR_QUEUE value! Must be a power of 2.
+#endif
+
+#ifndef OS_HEAP_TLSF
+#define OS_HEAP_TLSF          0 /* system heap is a list of segments (first fit) */
+#endif
+
+#ifndef OS_SLAB_SIZE
+#define OS_SLAB_SIZE          0 /* control blocks of objects are allocated directly on the system heap */
+#endif
+
+#ifndef OS_HEAP_STATS
+#define OS_HEAP_STATS         0 /* statistics of the system heap are not collected */
+#endif
+
+#ifndef OS_CPU_STATS
+#define OS_CPU_STATS          0 /* no CPU time accounting of tasks            */
+#endif
+
+#ifndef OS_STACK_STATS
+#define OS_STACK_STATS        0 /* stacks aren't painted, no high-water marks */
+#endif
+
+#ifndef OS_LOCK_STATS
+#define OS_LOCK_STATS         0 /* no profiling of the kernel lock windows    */
+#endif
+
+#ifndef OS_MPU_GUARD
+#define OS_MPU_GUARD          0 /* stacks of tasks aren't guarded by MPU      */
+#endif
+
+#ifndef OS_TRACE
+#define OS_TRACE              0 /* no kernel event trace                      */
+#endif
+
+#if     OS_TRACE & (OS_TRACE - 1) || OS_TRACE > 32768
+#error  osconfig.h: Incorrect OS_TRACE value! Must be a power of 2 not greater then 32768.
+#endif
+
+#ifndef OS_WHEEL_LEVELS
+#define OS_WHEEL_LEVELS       0 /* timers queue is a time sorted list */
+#endif
+
+#if     OS_WHEEL_LEVELS == 1 || OS_WHEEL_LEVELS * 5 >= OS_TIMER_SIZE
+#error  osconfig.h: Incorrect OS_WHEEL_LEVELS value! Must be greater then 1 and cover less then OS_TIMER_SIZE bits.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
 typedef struct __tmr tmr_t, * const tmr_id; // timer
 typedef struct __tsk tsk_t, * const tsk_id; // task
+typedef struct __mtx mtx_t, * const mtx_id; // mutex
+typedef struct __lcs lcs_t;                  // call site of the kernel lock
 typedef         void fun_t(); // timer/task procedure
 
 /* -------------------------------------------------------------------------- */
@@ -150,6 +222,23 @@ typedef struct __sys
 	volatile
 	cnt_t    cnt;   // system timer counter
 #endif
+#if OS_CPU_STATS
+	struct {
+	uint32_t stamp; // time stamp of the last CPU time accounting
+	uint64_t time;  // total accounted time
+	}        cpu;
+#endif
+#if OS_STACK_STATS
+	tsk_t  * stk;   // the first task found with damaged guard band of its stack
+#endif
+#if OS_LOCK_STATS
+	struct {
+	lcs_t  * site;  // call site of the current lock window, zero if the window isn't measured
+	uint32_t stamp; // time stamp of the beginning of the current lock window
+	uint64_t time;  // total time of the measured lock windows
+	lcs_t  * list;  // list of call sites with measured lock windows
+	}        lck;
+#endif
 }	sys_t;
 
 /* -------------------------------------------------------------------------- */
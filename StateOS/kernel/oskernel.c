@@ -40,7 +40,15 @@
 static
 void priv_tsk_idle( void )
 {
+#if HW_TIMER_SIZE == 0 && OS_TICKLESS_IDLE
+	// the sleep isn't measured as a lock window, a pending interrupt wakes up the core at once
+	port_set_lock();
+	if (IDLE.hdr.next == &IDLE)
+		System.cnt += port_tck_sleep(core_tmr_delay());
+	port_clr_lock();
+#else
 	__WFI();
+#endif
 }
 
 /* -------------------------------------------------------------------------- */
@@ -48,9 +56,16 @@ void priv_tsk_idle( void )
 static
 void priv_ctx_switchNow( void )
 {
+#if OS_LOCK_STATS
+	lcs_t *lcs = System.lck.site;
+	core_lck_leave();
+#endif
 	port_ctx_switch();
 	port_clr_lock(); port_set_barrier();
 	port_set_lock();
+#if OS_LOCK_STATS
+	core_lck_enter(lcs);
+#endif
 }
 
 /* -------------------------------------------------------------------------- */
@@ -78,6 +93,150 @@ void priv_rdy_remove( hdr_t *hdr )
 	prv->next = nxt;
 }
 
+/* -------------------------------------------------------------------------- */
+
+#if OS_ISR_QUEUE
+
+// queue of procedures deferred by interrupt handlers
+// producers (interrupt handlers) reserve records with an atomic increment of 'head' and don't use the kernel lock
+// the consumer (context switch handler) has the lowest priority, so all reserved records are complete when it runs
+// the consumer runs without the kernel lock, the procedures set it themselves, so the interrupts are never blocked for the whole queue
+
+static struct
+{
+	volatile unsigned head;  // number of reserved records
+	volatile unsigned tail;  // number of executed records
+	volatile bool     yield; // context switch requested by core_ctx_switch
+	struct __isr { isr_fun_t *fun; void *obj; unsigned arg; } data[OS_ISR_QUEUE];
+}	Isr;
+
+/* -------------------------------------------------------------------------- */
+
+bool core_isr_post( isr_fun_t *fun, void *obj, unsigned arg )
+{
+	unsigned tail = Isr.tail;
+	unsigned head = port_cnt_inc(&Isr.head, tail + (OS_ISR_QUEUE));
+
+	assert(port_isr_context());
+
+	if (head == tail + (OS_ISR_QUEUE))
+		return false; // queue is full
+
+	head %= (OS_ISR_QUEUE);
+	Isr.data[head].fun = fun;
+	Isr.data[head].obj = obj;
+	Isr.data[head].arg = arg;
+
+	port_ctx_switch();
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+// execute all deferred procedures, each of them sets the kernel lock by itself
+// the record is released after the procedure, so the producers can't overwrite it
+// context switch requests generated by them are discarded, the caller selects the next task anyway
+// return true if any procedure was executed
+
+static
+bool priv_isr_handler( void )
+{
+	struct __isr *rec;
+	unsigned tail;
+	bool     done = false;
+
+	for (;;)
+	{
+		port_ctx_clear();
+
+		tail = Isr.tail;
+		if (tail == Isr.head)
+			return done;
+
+		rec = &Isr.data[tail % (OS_ISR_QUEUE)];
+
+		rec->fun(rec->obj, rec->arg);
+
+		Isr.tail = tail + 1;
+		done = true;
+	}
+}
+
+#endif//OS_ISR_QUEUE
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TRACE
+
+// kernel event trace
+// records are written only with the kernel lock set, so the buffer has a single producer and needs no other lock
+// 'head' counts all records ever written, the record position is the counter modulo the size of the buffer
+
+trc_t Trace = { .hdr = { .magic=TRC_MAGIC, .version=TRC_VERSION, .size=sizeof(trc_rec_t), .count=OS_TRACE, .freq=CPU_TIME_FREQUENCY } };
+
+/* -------------------------------------------------------------------------- */
+
+void core_trc_event( unsigned type, const void *obj, unsigned arg )
+{
+	trc_rec_t *rec = &Trace.data[Trace.hdr.head++ & ((OS_TRACE)-1)];
+
+	rec->time = port_cpu_time();
+	rec->type = (uint16_t)type;
+	rec->arg  = (uint16_t)arg;
+	rec->obj  = (uintptr_t)obj;
+}
+
+#endif//OS_TRACE
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_LOCK_STATS
+
+// profiling of the kernel lock windows
+// a window is measured from setting to clearing of the kernel lock and is attributed to the call site which set the lock
+// nested locks belong to the window of the outermost one
+// the window interrupted by the context switch is continued when the task resumes
+
+void core_lck_enter( lcs_t *lcs )
+{
+	System.lck.site  = lcs;
+	System.lck.stamp = port_cpu_time();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_lck_leave( void )
+{
+	lcs_t  * lcs = System.lck.site;
+	uint32_t len;
+	unsigned bin;
+
+	if (lcs == 0)
+		return;
+
+	len = port_cpu_time() - System.lck.stamp;
+	System.lck.site = 0;
+	System.lck.time += len;
+
+	if (lcs->count++ == 0)
+	{
+		lcs->next = System.lck.list;
+		System.lck.list = lcs;
+	}
+
+	lcs->time += len;
+	for (bin = 0; bin < LCK_BINS - 1 && (len >> bin) > 1; bin++);
+	lcs->hist[bin]++;
+
+	if (len > lcs->max)
+	{
+		lcs->max = len;
+		core_trc_event(TRC_LOCK, lcs, len < 0xFFFFU ? len : 0xFFFFU);
+	}
+}
+
+#endif//OS_LOCK_STATS
+
 /* -------------------------------------------------------------------------- */
 // SYSTEM TIMER SERVICES
 /* -------------------------------------------------------------------------- */
@@ -86,6 +245,10 @@ tmr_t WAIT = { .hdr={ .prev=&WAIT, .next=&WAIT, .id=ID_TIMER }, .delay=INFINITE
 
 /* -------------------------------------------------------------------------- */
 
+#if OS_WHEEL_LEVELS == 0
+
+/* -------------------------------------------------------------------------- */
+
 static
 void priv_tmr_insert( tmr_t *tmr, tid_t id )
 {
@@ -109,6 +272,220 @@ void priv_tmr_remove( tmr_t *tmr )
 
 /* -------------------------------------------------------------------------- */
 
+#else //OS_WHEEL_LEVELS
+
+/* -------------------------------------------------------------------------- */
+// hierarchical timing wheel
+// level 'lvl' consists of 32 slots, each of them covers (1 << (5 * lvl)) ticks
+// a timer is placed in the lowest level, which range covers its expiration time
+// when the wheel time reaches the beginning of a slot of higher level, the slot is cascaded to the lower levels
+// when the wheel time reaches a slot of level 0, all its timers are moved to the WAIT queue and expire
+// timers which delay exceeds the range of the wheel are cascaded from the highest level again
+// timers counting indefinitely are kept in a separate queue
+// WAIT queue contains only expired timers, the first of them is the current timer (tmr_thisISR)
+
+#define WHL_BITS         5
+#define WHL_SIZE        (1U << WHL_BITS)
+#define WHL_MASK        (WHL_SIZE - 1)
+#define WHL_SPAN        ((cnt_t)(1) << (WHL_BITS * (OS_WHEEL_LEVELS)))
+#define WHL_BIT( idx )  (0x80000000UL >> (idx))
+
+static struct
+{
+	cnt_t    time;                                // the wheel time, all slots up to this time point have been processed
+	uint32_t map [OS_WHEEL_LEVELS];               // bitmaps of non-empty slots
+	hdr_t    slot[OS_WHEEL_LEVELS][WHL_SIZE];     // queues of timers, valid only for non-empty slots
+	hdr_t    inf;                                 // queue of timers counting indefinitely
+}	Wheel = { .inf = { .prev=&Wheel.inf, .next=&Wheel.inf } };
+
+/* -------------------------------------------------------------------------- */
+// return the number of ticks from the wheel time to the nearest event of the wheel
+// (expiration of a slot of level 0 or cascade of a slot of higher level)
+// return 0 if the wheel is empty
+
+static
+cnt_t priv_whl_next( void )
+{
+	cnt_t    dly = 0;
+	cnt_t    tck;
+	uint32_t map;
+	unsigned lvl, pos, idx;
+
+	for (lvl = 0; lvl < OS_WHEEL_LEVELS; lvl++)
+	{
+		if (Wheel.map[lvl] == 0)
+			continue;
+
+		pos = WHL_BITS * lvl;
+		idx = (unsigned)(Wheel.time >> pos) & WHL_MASK;
+		map = Wheel.map[lvl];
+		if (idx < WHL_MASK)
+			map = (map << (idx + 1)) | (map >> (WHL_MASK - idx));
+		idx = core_map_clz(map) + 1;
+		tck = (cnt_t)(((Wheel.time >> pos) + idx) << pos) - Wheel.time;
+
+		if (dly == 0 || tck < dly)
+			dly = tck;
+	}
+
+	return dly;
+}
+
+/* -------------------------------------------------------------------------- */
+// put timer 'tmr' into the wheel, 'dly' is the number of ticks from the wheel time to the expiration of the timer
+
+static
+void priv_whl_insert( tmr_t *tmr, cnt_t dly )
+{
+	hdr_t  * slot;
+	unsigned lvl = 0;
+	unsigned idx;
+
+	if (dly >= WHL_SPAN)
+		dly = WHL_SPAN - 1;
+
+	while (dly >> (WHL_BITS * (lvl + 1)))
+		lvl++;
+
+	idx  = (unsigned)((cnt_t)(Wheel.time + dly) >> (WHL_BITS * lvl)) & WHL_MASK;
+	slot = &Wheel.slot[lvl][idx];
+
+	if ((Wheel.map[lvl] & WHL_BIT(idx)) == 0)
+	{
+		Wheel.map[lvl] |= WHL_BIT(idx);
+		slot->prev = slot->next = slot;
+	}
+
+	priv_rdy_insert(&tmr->hdr, slot);
+}
+
+/* -------------------------------------------------------------------------- */
+// process all slots of the wheel for the current wheel time
+
+static
+void priv_whl_expire( void )
+{
+	hdr_t  * slot;
+	hdr_t  * prv;
+	tmr_t  * tmr;
+	tmr_t  * nxt;
+	unsigned lvl, idx;
+
+	for (lvl = 1; lvl < OS_WHEEL_LEVELS; lvl++)
+	{
+		if (Wheel.time & ((WHL_SIZE << (WHL_BITS * (lvl - 1))) - 1))
+			break;
+
+		idx = (unsigned)(Wheel.time >> (WHL_BITS * lvl)) & WHL_MASK;
+		if (Wheel.map[lvl] & WHL_BIT(idx))
+		{
+			Wheel.map[lvl] &= ~WHL_BIT(idx);
+			slot = &Wheel.slot[lvl][idx];
+			for (tmr = slot->next; tmr != (tmr_t *)slot; tmr = nxt)
+			{
+				nxt = tmr->hdr.next;
+				priv_whl_insert(tmr, (cnt_t)(tmr->start + tmr->delay - Wheel.time));
+			}
+		}
+	}
+
+	idx = (unsigned)(Wheel.time) & WHL_MASK;
+	if (Wheel.map[0] & WHL_BIT(idx))
+	{
+		Wheel.map[0] &= ~WHL_BIT(idx);
+		slot = &Wheel.slot[0][idx];
+		prv  = WAIT.hdr.prev;
+		prv->next = slot->next;
+		((hdr_t *)slot->next)->prev = prv;
+		((hdr_t *)slot->prev)->next = &WAIT;
+		WAIT.hdr.prev = slot->prev;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+// move the wheel time forward to the current time point
+// all expired timers are moved to the WAIT queue
+
+static
+void priv_whl_update( void )
+{
+	cnt_t now = core_sys_time();
+	cnt_t dly;
+
+	while (dly = priv_whl_next(), dly != 0 && dly <= (cnt_t)(now - Wheel.time))
+	{
+		Wheel.time += dly;
+		priv_whl_expire();
+	}
+
+	Wheel.time = now;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tmr_insert( tmr_t *tmr, tid_t id )
+{
+	cnt_t now, lag, dly;
+
+	tmr->hdr.id = id;
+
+	if (tmr->delay == INFINITE)
+	{
+		priv_rdy_insert(&tmr->hdr, &Wheel.inf);
+		return;
+	}
+
+	now = core_sys_time();
+	dly = (cnt_t)(now - tmr->start);
+
+	if (tmr->delay <= dly)
+	{
+		priv_rdy_insert(&tmr->hdr, &WAIT.hdr);
+		return;
+	}
+
+	dly = tmr->delay - dly;
+	lag = (cnt_t)(now - Wheel.time);
+
+	if (lag != 0)
+	{
+		cnt_t nxt = priv_whl_next();
+		if (nxt == 0 || nxt > lag)
+			Wheel.time = now, lag = 0; // there are no wheel events to process until now
+	}
+
+	if (dly >= WHL_SPAN - lag)
+		dly = WHL_SPAN;
+	else
+		dly += lag;
+
+	priv_whl_insert(tmr, dly);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tmr_remove( tmr_t *tmr )
+{
+	hdr_t  * nxt = tmr->hdr.next;
+	unsigned idx;
+
+	priv_rdy_remove(&tmr->hdr);
+
+	if (nxt->next == nxt && nxt >= Wheel.slot[0] && nxt < Wheel.slot[OS_WHEEL_LEVELS])
+	{
+		idx = (unsigned)(nxt - Wheel.slot[0]);
+		Wheel.map[idx / WHL_SIZE] &= ~WHL_BIT(idx % WHL_SIZE);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif//OS_WHEEL_LEVELS
+
+/* -------------------------------------------------------------------------- */
+
 void core_tmr_insert( tmr_t *tmr, tid_t id )
 {
 	priv_tmr_insert(tmr, id);
@@ -125,6 +502,114 @@ void core_tmr_remove( tmr_t *tmr )
 
 /* -------------------------------------------------------------------------- */
 
+#if OS_WHEEL_LEVELS == 0
+
+tmr_t *core_tmr_next( tmr_t *tmr )
+{
+	return tmr->hdr.next;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#else //OS_WHEEL_LEVELS
+
+tmr_t *core_tmr_next( tmr_t *tmr )
+{
+	hdr_t  * nxt = tmr->hdr.next;
+	unsigned idx;
+
+	if (nxt == &WAIT.hdr)
+	{
+		if (Wheel.inf.next != &Wheel.inf)
+			return Wheel.inf.next;
+		idx = 0;
+	}
+	else
+	if (nxt == &Wheel.inf)
+		idx = 0;
+	else
+	if (nxt >= Wheel.slot[0] && nxt < Wheel.slot[OS_WHEEL_LEVELS])
+		idx = (unsigned)(nxt - Wheel.slot[0]) + 1;
+	else
+		return (tmr_t *)nxt;
+
+	for (; idx < OS_WHEEL_LEVELS * WHL_SIZE; idx++)
+		if (Wheel.map[idx / WHL_SIZE] & WHL_BIT(idx % WHL_SIZE))
+			return Wheel.slot[0][idx].next;
+
+	return &WAIT;
+}
+
+#endif//OS_WHEEL_LEVELS
+
+/* -------------------------------------------------------------------------- */
+
+#if HW_TIMER_SIZE == 0
+
+cnt_t core_tmr_delay( void )
+{
+	cnt_t  dly;
+#if OS_WHEEL_LEVELS == 0
+	tmr_t *tmr = WAIT.hdr.next;
+
+	if (tmr->delay == INFINITE)
+		return INFINITE;
+
+	dly = (cnt_t)(System.cnt - tmr->start);
+	return tmr->delay > dly ? tmr->delay - dly : 0;
+#else
+	if (WAIT.hdr.next != &WAIT)
+		return 0;
+
+	dly = priv_whl_next();
+	if (dly == 0)
+		return INFINITE;
+
+	dly += Wheel.time - System.cnt;
+	return dly < ((CNT_MAX)>>1) ? dly : 0;
+#endif
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if HW_TIMER_SIZE
+
+#if OS_CPU_STATS
+// the longest tick-less sleep (in ticks), half of the period of the time stamp counter
+#define CPU_TIME_LIMIT ((cnt_t)((((uint64_t)1<<31)*(OS_FREQUENCY)/(CPU_TIME_FREQUENCY) < ((CNT_MAX)>>1)) ? \
+                                 ((uint64_t)1<<31)*(OS_FREQUENCY)/(CPU_TIME_FREQUENCY) : ((CNT_MAX)>>1)))
+#endif
+
+// start the hardware timer for the timeout 'start' + 'delay', don't start it if 'delay' is INFINITE
+// with the cpu statistics the timer expires at least every CPU_TIME_LIMIT ticks,
+// so core_tmr_handler accounts the cpu time before the time stamp counter wraps around
+
+static
+void priv_tmr_start( cnt_t start, cnt_t delay )
+{
+#if OS_CPU_STATS
+	cnt_t now = core_sys_time();
+
+	if (delay == INFINITE || (cnt_t)(delay - (cnt_t)(now - start)) > CPU_TIME_LIMIT)
+	{
+		start = now;
+		delay = CPU_TIME_LIMIT;
+	}
+#else
+	if (delay == INFINITE)
+		return;
+#endif
+	port_tmr_start((cnt_t)(start + delay));
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_WHEEL_LEVELS == 0
+
 #if HW_TIMER_SIZE
 
 static
@@ -132,13 +617,13 @@ bool priv_tmr_expired( tmr_t *tmr )
 {
 	port_tmr_stop();
 
-	if (tmr->delay == INFINITE)
-	return false; // return if timer counting indefinitely
-
-	if (tmr->delay <= (cnt_t)(core_sys_time() - tmr->start))
+	if (tmr->delay != INFINITE && tmr->delay <= (cnt_t)(core_sys_time() - tmr->start))
 	return true;  // return if timer finished counting
 
-	port_tmr_start((cnt_t)(tmr->start + tmr->delay));
+	priv_tmr_start(tmr->start, tmr->delay);
+
+	if (tmr->delay == INFINITE)
+	return false; // return if timer counting indefinitely
 
 	if (tmr->delay >  (cnt_t)(core_sys_time() - tmr->start))
 	return false; // return if timer still counts
@@ -158,95 +643,374 @@ bool priv_tmr_expired( tmr_t *tmr )
 	if (tmr->delay >= (cnt_t)(core_sys_time() - tmr->start + 1))
 	return false; // return if timer still counts or counting indefinitely
 
-	return true;  // timer finished counting
+	return true;  // timer finished counting
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#else //OS_WHEEL_LEVELS
+
+#if HW_TIMER_SIZE
+
+static
+bool priv_tmr_expired( tmr_t *tmr )
+{
+	cnt_t dly;
+
+	port_tmr_stop();
+
+	if (tmr != &WAIT)
+	return true;  // return if there is an expired timer in the WAIT queue
+
+	for (;;)
+	{
+		priv_whl_update();
+
+		if (WAIT.hdr.next != &WAIT)
+		return true;  // return if the wheel has released expired timers
+
+		dly = priv_whl_next();
+
+		priv_tmr_start(Wheel.time, dly ? dly : INFINITE);
+
+		if (dly == 0)
+		return false; // return if the wheel is empty
+
+		if (dly >  (cnt_t)(core_sys_time() - Wheel.time))
+		return false; // return if the wheel still counts
+
+		port_tmr_stop();
+
+		// however the wheel has finished counting, the event may be only a cascade of a slot
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+#else
+
+static
+bool priv_tmr_expired( tmr_t *tmr )
+{
+	if (tmr != &WAIT)
+	return true;  // return if there is an expired timer in the WAIT queue
+
+	priv_whl_update();
+
+	if (WAIT.hdr.next != &WAIT)
+	return true;  // return if the wheel has released expired timers
+
+	return false; // the wheel still counts
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#endif//OS_WHEEL_LEVELS
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tmr_wakeup( tmr_t *tmr, unsigned event )
+{
+	core_trc_event(TRC_TIMER, tmr, 0);
+
+	if (tmr->state)
+		tmr->state();
+
+	core_tmr_remove(tmr);
+	if (tmr->delay != 0) // a late periodic timer expires again at once, so no period is lost
+		priv_tmr_insert(tmr, ID_TIMER);
+
+	core_all_wakeup(&tmr->hdr.obj.queue, event);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tmr_handler( void )
+{
+	tmr_t *tmr;
+
+	core_stk_assert();
+
+	port_set_lock();
+	core_lck_enterHere();
+	{
+#if OS_CPU_STATS && HW_TIMER_SIZE
+		core_cpu_update(); // prevents the overflow of the time stamp counter in tick-less mode
+#endif
+		while (priv_tmr_expired(tmr = WAIT.hdr.next))
+		{
+			tmr = WAIT.hdr.next;
+
+			tmr->start += tmr->delay;
+
+			if (tmr->hdr.id == ID_TIMER)
+			{
+				tmr->delay = tmr->period;
+
+				priv_tmr_wakeup((tmr_t *)tmr, E_SUCCESS);
+			}
+			else  /* id == ID_DELAYED */
+				core_tsk_wakeup((tsk_t *)tmr, E_TIMEOUT);
+		}
+	}
+	core_lck_leave();
+	port_clr_lock();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+// SYSTEM TASK SERVICES
+/* -------------------------------------------------------------------------- */
+
+#ifndef MAIN_TOP
+static  stk_t     MAIN_STK[STK_SIZE(OS_STACK_SIZE)];
+#define MAIN_TOP (MAIN_STK+STK_SIZE(OS_STACK_SIZE))
+#endif
+
+static  union  { stk_t STK[STK_SIZE(OS_IDLE_STACK)];
+        struct { char  stk[STK_OVER(OS_IDLE_STACK)-sizeof(ctx_t)]; ctx_t ctx; } CTX; }
+        IDLE_STACK = { .CTX = { .ctx = _CTX_INIT(core_tsk_loop) } };
+#define IDLE_STK (void *)(&IDLE_STACK)
+#define IDLE_SP  (void *)(&IDLE_STACK.CTX.ctx)
+
+tsk_t MAIN = { .hdr={ .prev=&IDLE, .next=&IDLE, .id=ID_READY }, .stack=MAIN_TOP, .basic=OS_MAIN_PRIO, .prio=OS_MAIN_PRIO }; // main task
+tsk_t IDLE = { .hdr={ .prev=&MAIN, .next=&MAIN, .id=ID_IDLE  }, .state=priv_tsk_idle, .stack=IDLE_STK, .size=OS_IDLE_STACK, .sp=IDLE_SP }; // idle task and tasks queue
+sys_t System = { .cur=&MAIN };
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_EDF
+
+// return true if task 'tsk' has to be placed in front of task 'nxt' of the same priority
+// tasks with a deadline go before tasks without a deadline, then the earlier absolute deadline wins
+
+static
+bool priv_tsk_before( tsk_t *tsk, tsk_t *nxt )
+{
+	if (tsk->edf.dline == 0)
+		return false;
+	if (nxt->edf.dline == 0)
+		return true;
+
+	return (cnt_t)(nxt->edf.due - tsk->edf.due - 1) < ((CNT_MAX)>>1);
+}
+
+#else
+
+#define priv_tsk_before( tsk, nxt ) false
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_PRIO_LEVELS == 0
+
+#define PRIO_LEVEL( prio ) (prio)
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tsk_insert( tsk_t *tsk )
+{
+	tsk_t *nxt = &IDLE;
+#if OS_ROBIN && HW_TIMER_SIZE == 0
+	tsk->slice = 0;
+#endif
+#if OS_EDF
+	if (tsk->prio || tsk->edf.dline)
+		do nxt = nxt->hdr.next;
+		while (tsk->prio < nxt->prio || (tsk->prio == nxt->prio && nxt != &IDLE && !priv_tsk_before(tsk, nxt)));
+#else
+	if (tsk->prio)
+		do nxt = nxt->hdr.next;
+		while (tsk->prio <= nxt->prio);
+#endif
+
+	priv_rdy_insert(&tsk->hdr, &nxt->hdr);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tsk_remove( tsk_t *tsk )
+{
+	priv_rdy_remove(&tsk->hdr);
+}
+
+/* -------------------------------------------------------------------------- */
+// insert task 'tsk' into the READY queue searching for the place from task 'nxt'
+// return the place, where the search for the next task of the same or lower priority can start
+
+static
+tsk_t *priv_tsk_merge( tsk_t *tsk, tsk_t *nxt )
+{
+#if OS_EDF
+	priv_tsk_insert(tsk); // tasks of the same priority aren't sorted by deadlines in delayed queues
+#else
+#if OS_ROBIN && HW_TIMER_SIZE == 0
+	tsk->slice = 0;
+#endif
+	while (nxt != &IDLE && tsk->prio <= nxt->prio)
+		nxt = nxt->hdr.next;
+
+	priv_rdy_insert(&tsk->hdr, &nxt->hdr);
+#endif
+	return nxt;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_cur_reset( tsk_t *cur, unsigned prio )
+{
+	tsk_t *nxt = cur->hdr.next;
+
+	cur->prio = prio;
+	if (nxt->prio > prio)
+		port_ctx_switch();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#else //OS_PRIO_LEVELS
+
+/* -------------------------------------------------------------------------- */
+// the READY queue is divided into consecutive segments, one for each priority level
+// each segment is a fifo, the tail of every non-empty segment is stored in the table
+// level 'lvl' is represented by the bit (0x80000000 >> lvl) in the priority bitmap
+
+#define PRIO_LEVEL( prio ) ((prio) < (OS_PRIO_LEVELS) ? (prio) : (OS_PRIO_LEVELS)-1)
+#define PRIO_BIT( lvl )    (0x80000000UL >> (lvl))
+
+static struct { uint32_t map; tsk_t *tail[OS_PRIO_LEVELS]; } Ready =
+{
+	.map  = PRIO_BIT(PRIO_LEVEL(OS_MAIN_PRIO)),
+	.tail = { [PRIO_LEVEL(OS_MAIN_PRIO)] = &MAIN },
+};
+
+
+/* -------------------------------------------------------------------------- */
+// return the task after which the priority level 'lvl' begins in the READY queue
+// it is the tail of the nearest non-empty higher priority level or IDLE
+
+static
+tsk_t *priv_tsk_above( unsigned lvl )
+{
+	uint32_t map = Ready.map & (0x7FFFFFFFUL >> lvl);
+
+	return map ? Ready.tail[core_map_clz(map)] : &IDLE;
+}
+
+/* -------------------------------------------------------------------------- */
+// insert task 'tsk' at the end of its priority level (in order of deadlines in the EDF mode)
+
+static
+void priv_tsk_insert( tsk_t *tsk )
+{
+	unsigned lvl = PRIO_LEVEL(tsk->prio);
+	tsk_t  * prv;
+#if OS_ROBIN && HW_TIMER_SIZE == 0
+	tsk->slice = 0;
+#endif
+	if (tsk == &IDLE)
+		return; // IDLE is the guard of the READY queue and doesn't belong to any level
+
+	if (Ready.map & PRIO_BIT(lvl))
+	{
+		prv = Ready.tail[lvl];
+		while (prv != &IDLE && PRIO_LEVEL(prv->prio) == lvl && priv_tsk_before(tsk, prv))
+			prv = prv->hdr.prev;
+		if (prv == Ready.tail[lvl])
+			Ready.tail[lvl] = tsk;
+	}
+	else
+	{
+		prv = priv_tsk_above(lvl);
+		Ready.map |= PRIO_BIT(lvl);
+		Ready.tail[lvl] = tsk;
+	}
+
+	priv_rdy_insert(&tsk->hdr, prv->hdr.next);
 }
 
-#endif
-
 /* -------------------------------------------------------------------------- */
+// insert task 'tsk' at the beginning of its priority level
 
 static
-void priv_tmr_wakeup( tmr_t *tmr, unsigned event )
+void priv_tsk_push( tsk_t *tsk )
 {
-	if (tmr->state)
-		tmr->state();
+	unsigned lvl = PRIO_LEVEL(tsk->prio);
+	tsk_t  * prv = priv_tsk_above(lvl);
 
-	core_tmr_remove(tmr);
-	if (tmr->delay >= (cnt_t)(core_sys_time() - tmr->start + 1))
-		priv_tmr_insert(tmr, ID_TIMER);
+	if ((Ready.map & PRIO_BIT(lvl)) == 0)
+	{
+		Ready.map |= PRIO_BIT(lvl);
+		Ready.tail[lvl] = tsk;
+	}
 
-	core_all_wakeup(&tmr->hdr.obj.queue, event);
+	priv_rdy_insert(&tsk->hdr, prv->hdr.next);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_tmr_handler( void )
+static
+void priv_tsk_remove( tsk_t *tsk )
 {
-	tmr_t *tmr;
-
-	core_stk_assert();
+	unsigned lvl = PRIO_LEVEL(tsk->prio);
+	tsk_t  * prv = tsk->hdr.prev;
 
-	port_set_lock();
+	if (Ready.tail[lvl] == tsk)
 	{
-		while (priv_tmr_expired(tmr = WAIT.hdr.next))
-		{
-			tmr->start += tmr->delay;
-
-			if (tmr->hdr.id == ID_TIMER)
-			{
-				tmr->delay = tmr->period;
-
-				priv_tmr_wakeup((tmr_t *)tmr, E_SUCCESS);
-			}
-			else  /* id == ID_DELAYED */
-				core_tsk_wakeup((tsk_t *)tmr, E_TIMEOUT);
-		}
+		if (prv != &IDLE && PRIO_LEVEL(prv->prio) == lvl)
+			Ready.tail[lvl] = prv;
+		else
+			Ready.map &= ~PRIO_BIT(lvl);
 	}
-	port_clr_lock();
+
+	priv_rdy_remove(&tsk->hdr);
 }
 
 /* -------------------------------------------------------------------------- */
-// SYSTEM TASK SERVICES
-/* -------------------------------------------------------------------------- */
-
-#ifndef MAIN_TOP
-static  stk_t     MAIN_STK[STK_SIZE(OS_STACK_SIZE)];
-#define MAIN_TOP (MAIN_STK+STK_SIZE(OS_STACK_SIZE))
-#endif
+// insertion into the READY queue takes constant time, the search place isn't needed
 
-static  union  { stk_t STK[STK_SIZE(OS_IDLE_STACK)];
-        struct { char  stk[STK_OVER(OS_IDLE_STACK)-sizeof(ctx_t)]; ctx_t ctx; } CTX; }
-        IDLE_STACK = { .CTX = { .ctx = _CTX_INIT(core_tsk_loop) } };
-#define IDLE_STK (void *)(&IDLE_STACK)
-#define IDLE_SP  (void *)(&IDLE_STACK.CTX.ctx)
+static
+tsk_t *priv_tsk_merge( tsk_t *tsk, tsk_t *nxt )
+{
+	priv_tsk_insert(tsk);
 
-tsk_t MAIN = { .hdr={ .prev=&IDLE, .next=&IDLE, .id=ID_READY }, .stack=MAIN_TOP, .basic=OS_MAIN_PRIO, .prio=OS_MAIN_PRIO }; // main task
-tsk_t IDLE = { .hdr={ .prev=&MAIN, .next=&MAIN, .id=ID_IDLE  }, .state=priv_tsk_idle, .stack=IDLE_STK, .size=OS_IDLE_STACK, .sp=IDLE_SP }; // idle task and tasks queue
-sys_t System = { .cur=&MAIN };
+	return nxt;
+}
 
 /* -------------------------------------------------------------------------- */
+// the current task must always stay in the segment of its priority level
+// if it is still the highest priority task, it remains at the head of the READY queue
+// otherwise it is placed at the end of its new level and will be preempted
 
 static
-void priv_tsk_insert( tsk_t *tsk )
+void priv_cur_reset( tsk_t *cur, unsigned prio )
 {
-	tsk_t *nxt = &IDLE;
-#if OS_ROBIN && HW_TIMER_SIZE == 0
-	tsk->slice = 0;
-#endif
-	if (tsk->prio)
-		do nxt = nxt->hdr.next;
-		while (tsk->prio <= nxt->prio);
+	priv_tsk_remove(cur);
+	cur->prio = prio;
 
-	priv_rdy_insert(&tsk->hdr, &nxt->hdr);
+	if (priv_tsk_above(PRIO_LEVEL(prio)) == &IDLE)
+	{
+		priv_tsk_push(cur);
+	}
+	else
+	{
+		priv_tsk_insert(cur);
+		port_ctx_switch();
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 
-static
-void priv_tsk_remove( tsk_t *tsk )
-{
-	priv_rdy_remove(&tsk->hdr);
-}
+#endif//OS_PRIO_LEVELS
 
 /* -------------------------------------------------------------------------- */
 
@@ -272,7 +1036,9 @@ void core_tsk_remove( tsk_t *tsk )
 
 void core_ctx_init( tsk_t *tsk )
 {
-#ifdef DEBUG
+#if OS_STACK_STATS
+	core_stk_paint(tsk->stack, tsk->size);
+#elif defined(DEBUG)
 	memset(tsk->stack, 0xFF, tsk->size);
 #endif
 	tsk->sp = (ctx_t *)STK_CROP(tsk->stack, tsk->size) - 1;
@@ -285,8 +1051,13 @@ void core_ctx_switch( void )
 {
 	tsk_t *cur = IDLE.hdr.next;
 	tsk_t *nxt = cur->hdr.next;
-	if (nxt->prio == cur->prio)
+	if (PRIO_LEVEL(nxt->prio) == PRIO_LEVEL(cur->prio))
+	{
+#if OS_ISR_QUEUE
+		Isr.yield = true;
+#endif
 		port_ctx_switch();
+	}
 }
 
 /* -------------------------------------------------------------------------- */
@@ -295,25 +1066,44 @@ void core_tsk_loop( void )
 {
 	for (;;)
 	{
+		core_lck_leave();
 		port_clr_lock();
 		System.cur->state();
 		port_set_lock();
+		core_lck_enterHere();
 		core_ctx_switch();
 	}
 }
 
 /* -------------------------------------------------------------------------- */
 
+// delayed queue is sorted by priority, tasks of the same priority form a fifo run
+// the first task of the run points to the last one, the last task of the run points to the first one
+// so appending a task to the delayed queue takes time depending on the number of different priorities only
+// priority of the task mustn't be changed while the task is in the delayed queue
+
 void core_tsk_append( tsk_t *tsk, tsk_t **que )
 {
 	tsk_t *nxt = *que;
 	tsk->guard = que;
 
-	while (nxt && tsk->prio <= nxt->prio)
+	while (nxt && tsk->prio < nxt->prio)
+	{
+		que = &nxt->run->hdr.obj.queue;
+		nxt = *que;
+	}
+
+	if (nxt && tsk->prio == nxt->prio)
 	{
-		que = &nxt->hdr.obj.queue;
+		que = &nxt->run->hdr.obj.queue;
+		tsk->run = nxt;
+		nxt->run = tsk;
 		nxt = *que;
 	}
+	else
+	{
+		tsk->run = tsk;
+	}
 
 	if (nxt)
 		nxt->back = &tsk->hdr.obj.queue;
@@ -328,8 +1118,27 @@ void core_tsk_unlink( tsk_t *tsk, unsigned event )
 {
 	tsk_t**que = tsk->back;
 	tsk_t *nxt = tsk->hdr.obj.queue;
+	tsk_t *prv = que == tsk->guard ? 0 : (tsk_t *)que; // 'hdr.obj.queue' is the first field of the task
+	tsk_t *run = tsk->run;
 	tsk->event = event;
 
+	if (prv && prv->prio == tsk->prio)
+	{
+		if (!nxt || nxt->prio != tsk->prio) // the last task of the run
+		{
+			prv->run = run;
+			run->run = prv;
+		}
+	}
+	else
+	{
+		if (nxt && nxt->prio == tsk->prio)  // the first task of the run
+		{
+			nxt->run = run;
+			run->run = nxt;
+		}
+	}
+
 	if (nxt)
 		nxt->back = que;
 	*que = nxt;
@@ -352,6 +1161,8 @@ unsigned priv_tsk_wait( tsk_t *tsk, tsk_t **que, bool yield )
 {
 	assert(!port_isr_context());
 
+	core_trc_event(TRC_WAIT, tsk, tsk->delay);
+
 	core_tsk_append((tsk_t *)tsk, que);
 	priv_tsk_remove((tsk_t *)tsk);
 	core_tmr_insert((tmr_t *)tsk, ID_DELAYED);
@@ -421,8 +1232,19 @@ tsk_t *core_tsk_wakeup( tsk_t *tsk, unsigned event )
 {
 	if (tsk)
 	{
+		core_trc_event(TRC_WAKEUP, tsk, event);
 		core_tsk_unlink((tsk_t *)tsk, event);
 		core_tmr_remove((tmr_t *)tsk);
+		if (tsk->mtx.tree)
+		//	the task has left the delayed queue of the mutex (e.g. by timeout), the owner may lose the lent priority
+		{
+			mtx_t *mtx = tsk->mtx.tree;
+			tsk->mtx.tree = 0;
+			core_mtx_prio(mtx, 0);
+		}
+#if OS_EDF
+		tsk->edf.due = (event == E_TIMEOUT ? tsk->start : core_sys_time()) + tsk->edf.dline;
+#endif
 		core_tsk_insert((tsk_t *)tsk);
 	}
 
@@ -431,47 +1253,75 @@ tsk_t *core_tsk_wakeup( tsk_t *tsk, unsigned event )
 
 /* -------------------------------------------------------------------------- */
 
+// the whole delayed queue is detached at once
+// it is sorted by priority, so all its tasks are merged into the READY queue in a single pass
+// context switch is forced only once
+
 void core_all_wakeup( tsk_t **que, unsigned event )
 {
-	while (core_tsk_wakeup(*que, event));
+	tsk_t *cur = IDLE.hdr.next;
+	tsk_t *pos = cur;
+	tsk_t *tsk = *que;
+	tsk_t *nxt;
+
+	*que = 0;
+
+	for (; tsk; tsk = nxt)
+	{
+		core_trc_event(TRC_WAKEUP, tsk, event);
+		nxt = tsk->hdr.obj.queue;
+		tsk->hdr.obj.queue = 0; // necessary because of tsk_wait[Until|For] functions
+		tsk->guard = 0;
+		tsk->event = event;
+		tsk->mtx.tree = 0; // the whole queue has been detached, nothing is lent from it
+		core_tmr_remove((tmr_t *)tsk);
+#if OS_EDF
+		tsk->edf.due = (event == E_TIMEOUT ? tsk->start : core_sys_time()) + tsk->edf.dline;
+#endif
+		tsk->hdr.id = ID_READY;
+		pos = priv_tsk_merge(tsk, pos);
+	}
+
+	if (cur != IDLE.hdr.next)
+		port_ctx_switch();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void core_tsk_prio( tsk_t *tsk, unsigned prio )
 {
-	mtx_t *mtx;
-
 	if (prio < tsk->basic)
 		prio = tsk->basic;
 
-	for (mtx = tsk->mtx.list; mtx; mtx = mtx->list)
-		if (mtx->obj.queue)
-			if (prio < mtx->obj.queue->prio)
-				prio = mtx->obj.queue->prio;
+	if (tsk->mtx.list && prio < tsk->mtx.list->prio)
+		prio = tsk->mtx.list->prio;
 
 	if (tsk->prio != prio)
 	{
-		tsk->prio = prio;
-
 		if (tsk == System.cur)
 		{
-			tsk = tsk->hdr.next;
-			if (tsk->prio > prio)
-				port_ctx_switch();
+			priv_cur_reset(tsk, prio);
 		}
 		else
 		if (tsk->hdr.id == ID_READY)
 		{
 			priv_tsk_remove(tsk);
+			tsk->prio = prio;
 			core_tsk_insert(tsk);
 		}
 		else
 		if (tsk->hdr.id == ID_DELAYED)
 		{
-			core_tsk_transfer(tsk, tsk->guard);
+			tsk_t **que = tsk->guard;
+			core_tsk_unlink(tsk, tsk->event);
+			tsk->prio = prio;
+			core_tsk_append(tsk, que);
 			if (tsk->mtx.tree)
-				core_tsk_prio(tsk->mtx.tree, prio);
+				core_mtx_prio(tsk->mtx.tree, 0);
+		}
+		else
+		{
+			tsk->prio = prio;
 		}
 	}
 }
@@ -480,45 +1330,231 @@ void core_tsk_prio( tsk_t *tsk, unsigned prio )
 
 void core_cur_prio( unsigned prio )
 {
-	mtx_t *mtx;
 	tsk_t *tsk = System.cur;
 
 	if (prio < tsk->basic)
 		prio = tsk->basic;
 
-	for (mtx = tsk->mtx.list; mtx; mtx = mtx->list)
-		if (mtx->obj.queue)
-			if (prio < mtx->obj.queue->prio)
-				prio = mtx->obj.queue->prio;
+	if (tsk->mtx.list && prio < tsk->mtx.list->prio)
+		prio = tsk->mtx.list->prio;
 
 	if (tsk->prio != prio)
+		priv_cur_reset(tsk, prio);
+}
+
+/* -------------------------------------------------------------------------- */
+// list of mutexes held by the task is sorted by priorities inherited from the delayed queues of the mutexes
+// so the priority inherited by the task is always the priority of the first mutex in the list
+
+static
+void priv_mtx_insert( mtx_t *mtx, unsigned prio )
+{
+	mtx_t**lst = &mtx->owner->mtx.list;
+	mtx_t *nxt;
+
+	while ((nxt = *lst) && prio < nxt->prio)
+		lst = &nxt->list;
+
+	if (nxt)
+		nxt->back = &mtx->list;
+	mtx->back = lst;
+	mtx->list = nxt;
+	mtx->prio = prio;
+	*lst = mtx;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// return the priority inherited from the delayed queue of mutex 'mtx', not less than 'prio' and the priority ceiling
+
+static
+unsigned priv_mtx_prio( mtx_t *mtx, unsigned prio )
+{
+	if (prio < mtx->ceil)
+		prio = mtx->ceil;
+
+	if (mtx->obj.queue && prio < mtx->obj.queue->prio)
+		prio = mtx->obj.queue->prio;
+
+	return prio;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_mtx_remove( mtx_t *mtx )
+{
+	mtx_t**lst = mtx->back;
+	mtx_t *nxt = mtx->list;
+
+	if (nxt)
+		nxt->back = lst;
+	*lst = nxt;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_mtx_link( mtx_t *mtx, tsk_t *tsk )
+{
+	mtx->owner = tsk;
+
+	if (tsk)
+	{
+		priv_mtx_insert(mtx, priv_mtx_prio(mtx, 0));
+		core_tsk_prio(tsk, tsk->basic);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_mtx_unlink( mtx_t *mtx )
+{
+	tsk_t *tsk = mtx->owner;
+
+	if (tsk)
+	{
+		priv_mtx_remove(mtx);
+		mtx->list  = 0;
+		mtx->owner = 0;
+		core_tsk_prio(tsk, tsk->basic);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+// only the owners of mutexes, which inherited priorities have changed, are updated
+// so the priority inheritance walks only the changed part of the chain of blocked tasks
+
+void core_mtx_prio( mtx_t *mtx, unsigned prio )
+{
+	tsk_t *tsk = mtx->owner;
+
+	prio = priv_mtx_prio(mtx, prio);
+
+	if (tsk && mtx->prio != prio)
+	{
+		priv_mtx_remove(mtx);
+		priv_mtx_insert(mtx, prio);
+		core_tsk_prio(tsk, tsk->basic);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_CPU_STATS
+
+void core_cpu_update( void )
+{
+	uint32_t now = port_cpu_time();
+	uint32_t dly = now - System.cpu.stamp;
+
+	System.cpu.stamp = now;
+	System.cpu.time += dly;
+	System.cur->cpu.time += dly;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_STACK_STATS
+
+// the pattern of unused stack as a word of type stk_t
+#define STK_WORD ((stk_t)~(stk_t)0 / 0xFF * (STK_FILL))
+
+unsigned core_stk_used( void *stack, size_t size )
+{
+	stk_t *stk = stack;
+	stk_t *end = stk + LIMITED_SIZE(size, stk_t);
+
+	while (stk < end && *stk == STK_WORD)
+		stk++;
+
+	return (unsigned)((size_t)stack + size - (size_t)stk);
+}
+
+/* -------------------------------------------------------------------------- */
+// check only the guard band at the bottom of the stack of the preempted task
+// the first task found with damaged guard band is remembered
+
+static
+void priv_stk_check( tsk_t *tsk )
+{
+	stk_t *stk = tsk->stack;
+	stk_t *end = stk + LIMITED_SIZE(tsk->size, stk_t);
+
+	if (end > stk + STK_SIZE(OS_STACK_STATS))
+		end = stk + STK_SIZE(OS_STACK_STATS);
+
+	while (stk < end)
 	{
-		tsk->prio = prio;
-		tsk = tsk->hdr.next;
-		if (tsk->prio > prio)
-			port_ctx_switch();
+		if (*stk++ != STK_WORD)
+		{
+			if (System.stk == 0)
+				System.stk = tsk;
+			assert(false);
+			break;
+		}
 	}
 }
 
+#endif
+
+/* -------------------------------------------------------------------------- */
+// return the time slice of task 'tsk' (in ticks)
+
+static
+cnt_t priv_tsk_quantum( tsk_t *tsk )
+{
+#if OS_ROBIN
+	if (tsk->quant)
+		return tsk->quant;
+
+	return (OS_FREQUENCY)/(OS_ROBIN);
+#else
+	(void) tsk;
+
+	return 0;
+#endif
+}
+
 /* -------------------------------------------------------------------------- */
 
 void *core_tsk_handler( void *sp )
 {
 	tsk_t *cur, *nxt;
+#if OS_ISR_QUEUE
+	bool   isr;
+#endif
 
 	core_stk_assert();
 
+#if OS_ISR_QUEUE
+	isr = priv_isr_handler(); // before the kernel lock is set for the context switch
+#endif
+
 	port_set_lock();
+	core_lck_enterHere();
 	{
-		core_ctx_reset();
-
+#if OS_CPU_STATS
+		core_cpu_update();
+#endif
 		cur = System.cur;
 		cur->sp = sp;
 
+#if OS_STACK_STATS
+		priv_stk_check(cur);
+#endif
+
+#if OS_ISR_QUEUE
+		if (isr && !Isr.yield)
+			cur = 0; // deferred procedures alone don't rotate the current task
+		Isr.yield = false;
+#endif
+
 		nxt = IDLE.hdr.next;
 
 #if OS_ROBIN && HW_TIMER_SIZE == 0
-		if (cur == nxt || (nxt->slice >= (OS_FREQUENCY)/(OS_ROBIN) && (nxt->slice = 0) == 0))
+		if (cur == nxt || (nxt->slice >= priv_tsk_quantum(nxt) && (nxt->slice = 0) == 0))
 #else
 		if (cur == nxt)
 #endif
@@ -528,9 +1564,27 @@ void *core_tsk_handler( void *sp )
 			nxt = IDLE.hdr.next;
 		}
 
+		if (nxt != System.cur)
+		{
+#if OS_CPU_STATS
+			nxt->cpu.count++;
+#endif
+#if OS_STACK_STATS
+			if (nxt->sp == IDLE_SP) // the idle task is run for the first time, its stack hasn't been painted yet
+				core_stk_paint(IDLE_STK, (size_t)IDLE_SP - (size_t)IDLE_STK);
+#endif
+#if OS_MPU_GUARD
+			port_mpu_guard(nxt->stack, nxt->size);
+#endif
+			core_trc_event(TRC_SWITCH, nxt, 0);
+		}
+
 		System.cur = nxt;
 		sp = nxt->sp;
+
+		core_ctx_reset(priv_tsk_quantum(nxt));
 	}
+	core_lck_leave();
 	port_clr_lock();
 
 	return sp;
@@ -543,9 +1597,12 @@ void *core_tsk_handler( void *sp )
 void core_sys_tick( void )
 {
 	System.cnt++;
+#if OS_CPU_STATS
+	core_cpu_update(); // prevents the overflow of the time stamp counter when there is no context switch
+#endif
 	core_tmr_handler();
 	#if OS_ROBIN
-	if (++System.cur->slice >= (OS_FREQUENCY)/(OS_ROBIN))
+	if (++System.cur->slice >= priv_tsk_quantum(System.cur))
 		core_ctx_switch();
 	#endif
 }
@@ -553,3 +1610,65 @@ void core_sys_tick( void )
 #endif
 
 /* -------------------------------------------------------------------------- */
+
+// copy 'size' bytes from 'src' to 'dst'
+// if both areas have the same alignment, the data is copied by words, four at once if possible (LDM/STM)
+// a memcpy of constant size compiles to plain loads and stores and keeps the strict aliasing rules
+
+static
+void priv_mem_copy( char *dst, const char *src, unsigned size )
+{
+	if (size >= 2 * sizeof(unsigned) && (((size_t)dst ^ (size_t)src) & (sizeof(unsigned) - 1)) == 0)
+	{
+		while ((size_t)dst & (sizeof(unsigned) - 1))
+		{
+			*dst++ = *src++;
+			size--;
+		}
+
+		for (; size >= 4 * sizeof(unsigned); size -= 4 * sizeof(unsigned), dst += 4 * sizeof(unsigned), src += 4 * sizeof(unsigned))
+			memcpy(dst, src, 4 * sizeof(unsigned));
+		for (; size >= sizeof(unsigned); size -= sizeof(unsigned), dst += sizeof(unsigned), src += sizeof(unsigned))
+			memcpy(dst, src, sizeof(unsigned));
+	}
+
+	while (size--)
+		*dst++ = *src++;
+}
+
+/* -------------------------------------------------------------------------- */
+// the copy is split into at most two contiguous segments, so the wrap-around is checked only once
+
+unsigned core_buf_get( const char *buf, unsigned limit, unsigned pos, char *data, unsigned size )
+{
+	unsigned len = limit - pos;
+
+	if (size < len)
+	{
+		priv_mem_copy(data, &buf[pos], size);
+		return pos + size;
+	}
+
+	priv_mem_copy(data, &buf[pos], len);
+	priv_mem_copy(data + len, buf, size - len);
+	return size - len;
+}
+
+/* -------------------------------------------------------------------------- */
+
+unsigned core_buf_put( char *buf, unsigned limit, unsigned pos, const char *data, unsigned size )
+{
+	unsigned len = limit - pos;
+
+	if (size < len)
+	{
+		priv_mem_copy(&buf[pos], data, size);
+		return pos + size;
+	}
+
+	priv_mem_copy(&buf[pos], data, len);
+	priv_mem_copy(buf, data + len, size - len);
+	return size - len;
+}
+
+/* -------------------------------------------------------------------------- */
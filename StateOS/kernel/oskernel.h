@@ -35,6 +35,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "oscore.h"
+#include "ostrace.h"
 
 /* -------------------------------------------------------------------------- */
 
@@ -98,6 +99,112 @@ extern sys_t System; // system data
 __CONSTRUCTOR
 void port_sys_init( void );
 
+#if HW_TIMER_SIZE == 0 && OS_TICKLESS_IDLE
+// put the core to sleep for at most 'ticks' ticks of the system timer
+// the system timer must not generate any interrupt before the last of these ticks
+// return the number of ticks that passed without interrupts of the system timer
+// the procedure is called by the idle task with the kernel lock set
+cnt_t port_tck_sleep( cnt_t ticks );
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_ISR_QUEUE
+
+// procedure deferred by an interrupt handler
+typedef void isr_fun_t( void *obj, unsigned arg );
+
+// post procedure 'fun' with object 'obj' and argument 'arg' to the queue of deferred procedures
+// the procedure will be executed by the context switch handler without the kernel lock, it has to set the lock by itself
+// doesn't use the kernel lock, use only in handler mode
+// return false if the queue is full
+bool core_isr_post( isr_fun_t *fun, void *obj, unsigned arg );
+
+// post procedure 'fun' with object 'obj' and argument 'arg' to the queue of deferred procedures
+// return E_SUCCESS or E_TIMEOUT if the queue is full (result of the asynchronous procedures)
+__STATIC_INLINE
+unsigned core_isr_async( isr_fun_t *fun, void *obj, unsigned arg )
+{
+	assert(obj);
+
+	return core_isr_post(fun, obj, arg) ? E_SUCCESS : E_TIMEOUT;
+}
+
+// define asynchronous procedure 'fun'Async for objects of type 'type'
+// posting procedure 'fun' without argument (_ISR_ASYNC) or with argument of type unsigned (_ISR_ASYNC_ARG)
+#define _ISR_ASYNC( fun, type )                                                                                \
+        static void priv_##fun##Async( void *obj, unsigned arg ) { (void) arg; fun((type *) obj); }            \
+        unsigned fun##Async( type *obj ) { return core_isr_async(priv_##fun##Async, obj, 0); }
+
+#define _ISR_ASYNC_ARG( fun, type )                                                                            \
+        static void priv_##fun##Async( void *obj, unsigned arg ) { fun((type *) obj, arg); }                   \
+        unsigned fun##Async( type *obj, unsigned arg ) { return core_isr_async(priv_##fun##Async, obj, arg); }
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TRACE
+
+// kernel event trace buffer
+typedef struct __trc { trc_hdr_t hdr; trc_rec_t data[OS_TRACE]; } trc_t;
+
+extern trc_t Trace;
+
+// write record of type 'type' with object 'obj' and argument 'arg' to the trace buffer
+// the oldest record is overwritten when the buffer is full
+// doesn't use any additional lock, must be called with the kernel lock set
+void core_trc_event( unsigned type, const void *obj, unsigned arg );
+
+#else
+
+#define core_trc_event( type, obj, arg ) ((void)0)
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_LOCK_STATS
+
+// number of bins of the histogram of lock windows
+// bin 0 counts windows shorter then 2 counts of the time stamp counter, bin n counts windows from 2^n to 2^(n+1)-1 counts
+// the last bin counts all longer windows
+#define LCK_BINS     16
+
+// statistics of the lock windows started at the call site
+struct __lcs
+{
+	lcs_t      * next;  // next call site on the list of call sites with measured lock windows
+	const char * file;  // source file of the call site
+	unsigned     line;  // source line of the call site
+	uint32_t     count; // number of measured lock windows
+	uint32_t     max;   // length of the longest lock window
+	uint64_t     time;  // total length of the lock windows
+	uint32_t     hist[LCK_BINS]; // histogram of lengths of the lock windows
+};
+
+#define _LCS_INIT() { 0, __FILE__, __LINE__, 0, 0, 0, { 0 } }
+
+// begin measurement of the lock window started at call site 'lcs' (zero: the window isn't measured)
+// must be called just after the kernel lock has been set
+void core_lck_enter( lcs_t *lcs );
+
+// end measurement of the current lock window and record its length for its call site
+// must be called just before the kernel lock is cleared, does nothing if the window isn't measured
+void core_lck_leave( void );
+
+// begin measurement of the lock window started at the place of the macro
+#define core_lck_enterHere() \
+        do { static lcs_t __SITE = _LCS_INIT(); core_lck_enter(&__SITE); } while (0)
+
+#else
+
+#define core_lck_enter( lcs ) ((void)0)
+#define core_lck_leave()      ((void)0)
+#define core_lck_enterHere()  ((void)0)
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 // initiate task 'tsk' for context switch
@@ -111,6 +218,7 @@ __STATIC_INLINE
 void core_ctx_switchNow( void )
 {
 	core_ctx_switch();
+	core_lck_leave();
 	port_clr_lock(); port_set_barrier();
 }
 
@@ -118,11 +226,35 @@ void core_ctx_switchNow( void )
 __NO_RETURN
 void core_tsk_loop( void );
 
+#if OS_STACK_STATS
+
+// pattern of the unused part of the stack (repeated byte)
+#define STK_FILL     0xA5
+
+// paint stack area 'stack' of size 'size' (in bytes) with the pattern
+__STATIC_INLINE
+void core_stk_paint( void *stack, size_t size )
+{
+	memset(stack, STK_FILL, size);
+}
+
+// return the high-water mark of stack area 'stack' of size 'size' (in bytes)
+// the stack area is scanned from the bottom to the first word that differs from the pattern
+unsigned core_stk_used( void *stack, size_t size );
+
+#endif
+
+#if OS_CPU_STATS
+// add the time elapsed from the last accounting to the run time of the current task and to the total time
+void core_cpu_update( void );
+#endif
+
 // reset context switch indicator
+// 'slice' is the time slice of the next task (in ticks)
 __STATIC_INLINE
-void core_ctx_reset( void )
+void core_ctx_reset( cnt_t slice )
 {
-	port_ctx_reset();
+	port_ctx_reset(slice);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -133,9 +265,19 @@ void core_tmr_insert( tmr_t *tmr, tid_t id );
 // remove timer 'tmr' from timers READY queue
 void core_tmr_remove( tmr_t *tmr );
 
+// return the next object (timer or delayed task) in the timers queue after 'tmr'
+// start the iteration with '&WAIT', return '&WAIT' at the end of the queue
+tmr_t *core_tmr_next( tmr_t *tmr );
+
 // timers queue handler procedure
 void core_tmr_handler( void );
 
+#if HW_TIMER_SIZE == 0
+// return the number of ticks to the nearest event of the timers queue
+// return INFINITE if the timers queue is empty
+cnt_t core_tmr_delay( void );
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 // reset stack and restart the current task
@@ -212,14 +354,26 @@ tsk_t *core_one_wakeup( tsk_t **que, unsigned event )
 // resume execution of all tasks from delayed queue 'que' with event value 'event'
 // remove all tasks from delayed queue 'que'
 // remove all resumed tasks from timers READY queue
-// insert all resumed tasks into tasks READY queue
-// force context switch if priority of any resumed task is greater then priority of the current task and kernel works in preemptive mode
+// insert all resumed tasks into tasks READY queue in a single pass
+// force context switch (once) if priority of any resumed task is greater then priority of the current task and kernel works in preemptive mode
 void core_all_wakeup( tsk_t **que, unsigned event );
 
 // set task 'tsk' priority
 // force context switch if new priority of task 'tsk' is greater then priority of current task and kernel works in preemptive mode
 void core_tsk_prio( tsk_t *tsk, unsigned prio );
 
+// set owner 'tsk' of mutex 'mtx' and insert the mutex into the list of mutexes held by the task
+// update priority of task 'tsk' with priority inherited from the delayed queue of the mutex
+void core_mtx_link( mtx_t *mtx, tsk_t *tsk );
+
+// remove mutex 'mtx' from the list of mutexes held by its owner and clear the owner
+// update priority of the previous owner
+void core_mtx_unlink( mtx_t *mtx );
+
+// update priority inherited from the delayed queue of mutex 'mtx' (not less than 'prio' and the priority ceiling)
+// update priority of the mutex owner and priorities of tasks in the chain of blocked tasks, as far as they change
+void core_mtx_prio( mtx_t *mtx, unsigned prio );
+
 // set the current task priority
 // force context switch if new priority of the current task is less then priority of next task in ready queue and kernel works in preemptive mode
 void core_cur_prio( unsigned prio );
@@ -232,6 +386,33 @@ void *core_tsk_handler( void *sp );
 
 /* -------------------------------------------------------------------------- */
 
+// return the number of leading zero bits of the bitmap 'map' (map != 0)
+__STATIC_INLINE
+unsigned core_map_clz( uint32_t map )
+{
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+	return __CLZ(map);
+#else
+	unsigned cnt = 0;
+
+	if ((map & 0xFFFF0000UL) == 0) { cnt += 16; map <<= 16; }
+	if ((map & 0xFF000000UL) == 0) { cnt +=  8; map <<=  8; }
+	if ((map & 0xF0000000UL) == 0) { cnt +=  4; map <<=  4; }
+	if ((map & 0xC0000000UL) == 0) { cnt +=  2; map <<=  2; }
+	if ((map & 0x80000000UL) == 0) { cnt +=  1; }
+
+	return cnt;
+#endif
+}
+
+// copy 'size' bytes from the ring buffer 'buf' of size 'limit' (in bytes), starting at position 'pos', to 'data'
+// return the position in the ring buffer following the copied data
+unsigned core_buf_get( const char *buf, unsigned limit, unsigned pos, char *data, unsigned size );
+
+// copy 'size' bytes from 'data' to the ring buffer 'buf' of size 'limit' (in bytes), starting at position 'pos'
+// return the position in the ring buffer following the copied data
+unsigned core_buf_put( char *buf, unsigned limit, unsigned pos, const char *data, unsigned size );
+
 // return current system time in tick-less mode
 #if HW_TIMER_SIZE < OS_TIMER_SIZE // because of CSMCC
 cnt_t port_sys_time( void );
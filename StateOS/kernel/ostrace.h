@@ -0,0 +1,89 @@
+/******************************************************************************
+
+    @file    StateOS: ostrace.h
+    @author  Rajmund Szymanski
+    @date    04.09.2018
+    @brief   This file defines the layout of the kernel event trace buffer for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOSTRACE_H
+#define __STATEOSTRACE_H
+
+#include <stdint.h>
+
+/* -------------------------------------------------------------------------- */
+// the file is shared with the host decoder of the trace (tools/.ostrace)
+// so it mustn't depend on any other header of the system
+/* -------------------------------------------------------------------------- */
+
+#define TRC_MAGIC    0x43525453UL // "STRC", also identifies endianness of the target
+#define TRC_VERSION  2
+
+/* -------------------------------------------------------------------------- */
+
+// trace record types
+
+enum
+{
+	TRC_SWITCH = 1, // context switch,             obj: next task,                arg: 0
+	TRC_WAIT,       // task suspended,             obj: task,                     arg: delay (low 16 bits)
+	TRC_WAKEUP,     // task resumed,               obj: task,                     arg: event value (low 16 bits)
+	TRC_TIMER,      // timer finished countdown,   obj: timer,                    arg: 0
+	TRC_GIVE,       // object given / released,    obj: object,                   arg: result or value (low 16 bits)
+	TRC_TAKE,       // object taken / locked,      obj: object,                   arg: result or value (low 16 bits)
+	TRC_LOCK,       // new longest lock window,    obj: call site (lcs_t),        arg: length in counts of the time stamp counter (saturated to 16 bits)
+};
+
+/* -------------------------------------------------------------------------- */
+
+// trace record
+
+typedef struct __trc_rec
+{
+	uint32_t time;  // time stamp (port_cpu_time)
+	uint16_t type;  // record type
+	uint16_t arg;   // argument
+	uintptr_t obj;  // address of the object, the size of the record depends on the size of pointers of the target
+}	trc_rec_t;
+
+/* -------------------------------------------------------------------------- */
+
+// header of the trace buffer, followed by 'count' records
+// 'head' is the number of records ever written, the last 'count' of them are stored in the buffer
+
+typedef struct __trc_hdr
+{
+	uint32_t magic;   // TRC_MAGIC
+	uint8_t  version; // TRC_VERSION
+	uint8_t  size;    // size of the record (sizeof(trc_rec_t))
+	uint16_t count;   // size of the buffer (number of records, power of 2)
+	uint32_t freq;    // frequency of the time stamp counter (Hz)
+	uint32_t head;    // number of records written
+}	trc_hdr_t;
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOSTRACE_H
@@ -33,6 +33,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of bar_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(bar_t));
+
 /* -------------------------------------------------------------------------- */
 void bar_init( bar_t *bar, unsigned limit )
 /* -------------------------------------------------------------------------- */
@@ -64,9 +70,9 @@ bar_t *bar_create( unsigned limit )
 
 	sys_lock();
 	{
-		bar = sys_alloc(sizeof(bar_t));
+		bar = sys_slabAlloc(&Slab);
 		bar_init(bar, limit);
-		bar->obj.res = bar;
+		bar->obj.res = SLB_RES(bar);
 	}
 	sys_unlock();
 
@@ -96,7 +102,7 @@ void bar_delete( bar_t *bar )
 	sys_lock();
 	{
 		bar_kill(bar);
-		sys_free(bar->obj.res);
+		sys_slabFree(&bar->obj);
 	}
 	sys_unlock();
 }
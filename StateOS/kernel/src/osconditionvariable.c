@@ -33,6 +33,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of cnd_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(cnd_t));
+
 /* -------------------------------------------------------------------------- */
 void cnd_init( cnd_t *cnd )
 /* -------------------------------------------------------------------------- */
@@ -59,9 +65,9 @@ cnd_t *cnd_create( void )
 
 	sys_lock();
 	{
-		cnd = sys_alloc(sizeof(cnd_t));
+		cnd = sys_slabAlloc(&Slab);
 		cnd_init(cnd);
-		cnd->obj.res = cnd;
+		cnd->obj.res = SLB_RES(cnd);
 	}
 	sys_unlock();
 
@@ -89,7 +95,7 @@ void cnd_delete( cnd_t *cnd )
 	sys_lock();
 	{
 		cnd_kill(cnd);
-		sys_free(cnd->obj.res);
+		sys_slabFree(&cnd->obj);
 	}
 	sys_unlock();
 }
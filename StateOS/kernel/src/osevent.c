@@ -33,6 +33,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of evt_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(evt_t));
+
 /* -------------------------------------------------------------------------- */
 void evt_init( evt_t *evt )
 /* -------------------------------------------------------------------------- */
@@ -57,9 +63,9 @@ evt_t *evt_create( void )
 
 	sys_lock();
 	{
-		evt = sys_alloc(sizeof(evt_t));
+		evt = sys_slabAlloc(&Slab);
 		evt_init(evt);
-		evt->obj.res = evt;
+		evt->obj.res = SLB_RES(evt);
 	}
 	sys_unlock();
 
@@ -87,7 +93,7 @@ void evt_delete( evt_t *evt )
 	sys_lock();
 	{
 		evt_kill(evt);
-		sys_free(evt->obj.res);
+		sys_slabFree(&evt->obj);
 	}
 	sys_unlock();
 }
@@ -112,6 +118,7 @@ unsigned evt_waitFor( evt_t *evt, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_evt_wait(evt, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, evt, event);
 	}
 	sys_unlock();
 
@@ -127,6 +134,7 @@ unsigned evt_waitUntil( evt_t *evt, cnt_t time )
 	sys_lock();
 	{
 		event = priv_evt_wait(evt, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, evt, event);
 	}
 	sys_unlock();
 
@@ -142,8 +150,19 @@ void evt_give( evt_t *evt, unsigned event )
 	sys_lock();
 	{
 		core_all_wakeup(&evt->obj.queue, event);
+		core_trc_event(TRC_GIVE, evt, event);
 	}
 	sys_unlock();
 }
 
 /* -------------------------------------------------------------------------- */
+
+#if OS_ISR_QUEUE
+
+/* -------------------------------------------------------------------------- */
+_ISR_ASYNC_ARG( evt_give, evt_t ) // unsigned evt_giveAsync( evt_t *evt, unsigned event )
+/* -------------------------------------------------------------------------- */
+
+#endif
+
+/* -------------------------------------------------------------------------- */
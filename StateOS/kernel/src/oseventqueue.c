@@ -186,6 +186,7 @@ unsigned evq_take( evq_t *evq, unsigned *data )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_TAKE, evq, event);
 	}
 	sys_unlock();
 
@@ -219,6 +220,7 @@ unsigned evq_waitFor( evq_t *evq, unsigned *data, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_evq_wait(evq, data, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, evq, event);
 	}
 	sys_unlock();
 
@@ -234,6 +236,7 @@ unsigned evq_waitUntil( evq_t *evq, unsigned *data, cnt_t time )
 	sys_lock();
 	{
 		event = priv_evq_wait(evq, data, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, evq, event);
 	}
 	sys_unlock();
 
@@ -259,6 +262,7 @@ unsigned evq_give( evq_t *evq, unsigned data )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_GIVE, evq, event);
 	}
 	sys_unlock();
 
@@ -292,6 +296,7 @@ unsigned evq_sendFor( evq_t *evq, unsigned data, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_evq_send(evq, data, delay, core_tsk_waitFor);
+		core_trc_event(TRC_GIVE, evq, event);
 	}
 	sys_unlock();
 
@@ -307,6 +312,7 @@ unsigned evq_sendUntil( evq_t *evq, unsigned data, cnt_t time )
 	sys_lock();
 	{
 		event = priv_evq_send(evq, data, time, core_tsk_waitUntil);
+		core_trc_event(TRC_GIVE, evq, event);
 	}
 	sys_unlock();
 
@@ -334,6 +340,7 @@ unsigned evq_push( evq_t *evq, unsigned data )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_GIVE, evq, event);
 	}
 	sys_unlock();
 
@@ -341,3 +348,13 @@ unsigned evq_push( evq_t *evq, unsigned data )
 }
 
 /* -------------------------------------------------------------------------- */
+
+#if OS_ISR_QUEUE
+
+/* -------------------------------------------------------------------------- */
+_ISR_ASYNC_ARG( evq_give, evq_t ) // unsigned evq_giveAsync( evq_t *evq, unsigned data )
+/* -------------------------------------------------------------------------- */
+
+#endif
+
+/* -------------------------------------------------------------------------- */
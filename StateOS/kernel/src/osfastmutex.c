@@ -33,6 +33,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of mut_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(mut_t));
+
 /* -------------------------------------------------------------------------- */
 void mut_init( mut_t *mut )
 /* -------------------------------------------------------------------------- */
@@ -59,9 +65,9 @@ mut_t *mut_create( void )
 
 	sys_lock();
 	{
-		mut = sys_alloc(sizeof(mut_t));
+		mut = sys_slabAlloc(&Slab);
 		mut_init(mut);
-		mut->obj.res = mut;
+		mut->obj.res = SLB_RES(mut);
 	}
 	sys_unlock();
 
@@ -89,7 +95,7 @@ void mut_delete( mut_t *mut )
 	sys_lock();
 	{
 		mut_kill(mut);
-		sys_free(mut->obj.res);
+		sys_slabFree(&mut->obj);
 	}
 	sys_unlock();
 }
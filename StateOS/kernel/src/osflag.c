@@ -34,6 +34,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of flg_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(flg_t));
+
 /* -------------------------------------------------------------------------- */
 void flg_init( flg_t *flg, unsigned init )
 /* -------------------------------------------------------------------------- */
@@ -62,9 +68,9 @@ flg_t *flg_create( unsigned init )
 
 	sys_lock();
 	{
-		flg = sys_alloc(sizeof(flg_t));
+		flg = sys_slabAlloc(&Slab);
 		flg_init(flg, init);
-		flg->obj.res = flg;
+		flg->obj.res = SLB_RES(flg);
 	}
 	sys_unlock();
 
@@ -92,7 +98,7 @@ void flg_delete( flg_t *flg )
 	sys_lock();
 	{
 		flg_kill(flg);
-		sys_free(flg->obj.res);
+		sys_slabFree(&flg->obj);
 	}
 	sys_unlock();
 }
@@ -116,6 +122,7 @@ unsigned flg_take( flg_t *flg, unsigned flags, char mode )
 			event = E_SUCCESS;
 		else
 			event = E_TIMEOUT;
+		core_trc_event(TRC_TAKE, flg, event);
 	}
 	sys_unlock();
 
@@ -153,6 +160,7 @@ unsigned flg_waitFor( flg_t *flg, unsigned flags, char mode, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_flg_wait(flg, flags, mode, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, flg, event);
 	}
 	sys_unlock();
 
@@ -168,6 +176,7 @@ unsigned flg_waitUntil( flg_t *flg, unsigned flags, char mode, cnt_t time )
 	sys_lock();
 	{
 		event = priv_flg_wait(flg, flags, mode, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, flg, event);
 	}
 	sys_unlock();
 
@@ -189,7 +198,7 @@ unsigned flg_give( flg_t *flg, unsigned flags )
 		state = flg->flags;
 		flags = flg->flags |= flags;
 
-		for (obj = &flg->obj; obj->queue; obj = &obj->queue->hdr.obj)
+		for (obj = &flg->obj; obj->queue; )
 		{
 			tsk = obj->queue;
 			if (tsk->tmp.flg.flags & flags)
@@ -198,11 +207,16 @@ unsigned flg_give( flg_t *flg, unsigned flags )
 					flg->flags &= ~tsk->tmp.flg.flags;
 				tsk->tmp.flg.flags &= ~flags;
 				if (tsk->tmp.flg.flags == 0 || (tsk->tmp.flg.mode & flgAll) == 0)
+				{
 					core_tsk_wakeup(tsk, E_SUCCESS);
+					continue; // the task has been removed from the queue
+				}
 			}
+			obj = &tsk->hdr.obj;
 		}
 
 		flags = flg->flags;
+		core_trc_event(TRC_GIVE, flg, flags);
 	}
 	sys_unlock();
 
@@ -228,3 +242,13 @@ unsigned flg_clear( flg_t *flg, unsigned flags )
 }
 
 /* -------------------------------------------------------------------------- */
+
+#if OS_ISR_QUEUE
+
+/* -------------------------------------------------------------------------- */
+_ISR_ASYNC_ARG( flg_give, flg_t ) // unsigned flg_giveAsync( flg_t *flg, unsigned flags )
+/* -------------------------------------------------------------------------- */
+
+#endif
+
+/* -------------------------------------------------------------------------- */
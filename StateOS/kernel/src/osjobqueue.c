@@ -186,7 +186,9 @@ unsigned job_take( job_t *job )
 		if (job->count > 0)
 		{
 			fun = priv_job_getUpdate(job);
+			core_trc_event(TRC_TAKE, job, E_SUCCESS);
 
+			core_lck_leave();
 			port_clr_lock();
 			fun();
 
@@ -195,6 +197,7 @@ unsigned job_take( job_t *job )
 		else
 		{
 			event = E_TIMEOUT;
+			core_trc_event(TRC_TAKE, job, event);
 		}
 	}
 	sys_unlock();
@@ -224,8 +227,11 @@ unsigned priv_job_wait( job_t *job, cnt_t time, unsigned(*wait)(tsk_t**,cnt_t) )
 		fun = System.cur->tmp.job.fun;
 	}
 
+	core_trc_event(TRC_TAKE, job, event); // before the kernel lock is released for the job
+
 	if (event == E_SUCCESS)
 	{
+		core_lck_leave();
 		port_clr_lock();
 		fun();
 	}
@@ -283,6 +289,7 @@ unsigned job_give( job_t *job, fun_t *fun )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_GIVE, job, event);
 	}
 	sys_unlock();
 
@@ -317,6 +324,7 @@ unsigned job_sendFor( job_t *job, fun_t *fun, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_job_send(job, fun, delay, core_tsk_waitFor);
+		core_trc_event(TRC_GIVE, job, event);
 	}
 	sys_unlock();
 
@@ -332,6 +340,7 @@ unsigned job_sendUntil( job_t *job, fun_t *fun, cnt_t time )
 	sys_lock();
 	{
 		event = priv_job_send(job, fun, time, core_tsk_waitUntil);
+		core_trc_event(TRC_GIVE, job, event);
 	}
 	sys_unlock();
 
@@ -360,6 +369,7 @@ unsigned job_push( job_t *job, fun_t *fun )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_GIVE, job, event);
 	}
 	sys_unlock();
 
@@ -34,6 +34,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of lst_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(lst_t));
+
 /* -------------------------------------------------------------------------- */
 void lst_init( lst_t *lst )
 /* -------------------------------------------------------------------------- */
@@ -60,9 +66,9 @@ lst_t *lst_create( void )
 
 	sys_lock();
 	{
-		lst = sys_alloc(sizeof(lst_t));
+		lst = sys_slabAlloc(&Slab);
 		lst_init(lst);
-		lst->obj.res = lst;
+		lst->obj.res = SLB_RES(lst);
 	}
 	sys_unlock();
 
@@ -90,11 +96,33 @@ void lst_delete( lst_t *lst )
 	sys_lock();
 	{
 		lst_kill(lst);
-		sys_free(lst->obj.res);
+		sys_slabFree(&lst->obj);
 	}
 	sys_unlock();
 }
 
+/* -------------------------------------------------------------------------- */
+static
+void priv_lst_get( lst_t *lst, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	*data = lst->head.next + 1;
+	lst->head.next = lst->head.next->next;
+	if (lst->head.next == 0) lst->tail = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_lst_put( lst_t *lst, que_t *prv, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	que_t *ptr = (que_t *)data - 1;
+
+	ptr->next = prv->next;
+	prv->next = ptr;
+	if (ptr->next == 0) lst->tail = ptr;
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned lst_take( lst_t *lst, void **data )
 /* -------------------------------------------------------------------------- */
@@ -108,14 +136,14 @@ unsigned lst_take( lst_t *lst, void **data )
 	{
 		if (lst->head.next)
 		{
-			*data = lst->head.next + 1;
-			lst->head.next = lst->head.next->next;
+			priv_lst_get(lst, data);
 			event = E_SUCCESS;
 		}
 		else
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_TAKE, lst, event);
 	}
 	sys_unlock();
 
@@ -133,8 +161,7 @@ unsigned priv_lst_wait( lst_t *lst, void **data, cnt_t time, unsigned(*wait)(tsk
 
 	if (lst->head.next)
 	{
-		*data = lst->head.next + 1;
-		lst->head.next = lst->head.next->next;
+		priv_lst_get(lst, data);
 		return E_SUCCESS;
 	}
 
@@ -151,6 +178,7 @@ unsigned lst_waitFor( lst_t *lst, void **data, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_lst_wait(lst, data, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, lst, event);
 	}
 	sys_unlock();
 
@@ -166,6 +194,7 @@ unsigned lst_waitUntil( lst_t *lst, void **data, cnt_t time )
 	sys_lock();
 	{
 		event = priv_lst_wait(lst, data, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, lst, event);
 	}
 	sys_unlock();
 
@@ -175,12 +204,39 @@ unsigned lst_waitUntil( lst_t *lst, void **data, cnt_t time )
 /* -------------------------------------------------------------------------- */
 void lst_give( lst_t *lst, const void *data )
 /* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+
+	assert(lst);
+	assert(data);
+
+	sys_lock();
+	{
+		tsk = core_one_wakeup(&lst->obj.queue, E_SUCCESS);
+
+		if (tsk)
+		{
+			*tsk->tmp.lst.data.out = data;
+		}
+		else
+		{
+			priv_lst_put(lst, lst->tail ? lst->tail : &lst->head, data);
+		}
+		core_trc_event(TRC_GIVE, lst, E_SUCCESS);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void lst_giveOrdered( lst_t *lst, const void *data, int (*cmp)( const void *, const void * ) )
+/* -------------------------------------------------------------------------- */
 {
 	tsk_t *tsk;
 	que_t *ptr;
 
 	assert(lst);
 	assert(data);
+	assert(cmp);
 
 	sys_lock();
 	{
@@ -192,10 +248,10 @@ void lst_give( lst_t *lst, const void *data )
 		}
 		else
 		{
-			for (ptr = &lst->head; ptr->next; ptr = ptr->next);
-			ptr->next = (que_t *)data - 1;
-			ptr->next->next = 0;
+			for (ptr = &lst->head; ptr->next && cmp(data, ptr->next + 1) <= 0; ptr = ptr->next);
+			priv_lst_put(lst, ptr, data);
 		}
+		core_trc_event(TRC_GIVE, lst, E_SUCCESS);
 	}
 	sys_unlock();
 }
@@ -131,13 +131,8 @@ static
 void priv_box_get( box_t *box, char *data )
 /* -------------------------------------------------------------------------- */
 {
-	unsigned i = box->head;
-	unsigned j = 0;
-
-	do data[j++] = box->data[i++]; while (j < box->size);
-
-	box->head = (i < box->limit) ? i : 0;
-	box->count -= j;
+	box->count -= box->size;
+	box->head = core_buf_get(box->data, box->limit, box->head, data, box->size);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -145,13 +140,8 @@ static
 void priv_box_put( box_t *box, const char *data )
 /* -------------------------------------------------------------------------- */
 {
-	unsigned i = box->tail;
-	unsigned j = 0;
-
-	do box->data[i++] = data[j++]; while (j < box->size);
-
-	box->tail = (i < box->limit) ? i : 0;
-	box->count += j;
+	box->count += box->size;
+	box->tail = core_buf_put(box->data, box->limit, box->tail, data, box->size);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -208,6 +198,7 @@ unsigned box_take( box_t *box, void *data )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_TAKE, box, event);
 	}
 	sys_unlock();
 
@@ -242,6 +233,7 @@ unsigned box_waitFor( box_t *box, void *data, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_box_wait(box, data, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, box, event);
 	}
 	sys_unlock();
 
@@ -257,6 +249,7 @@ unsigned box_waitUntil( box_t *box, void *data, cnt_t time )
 	sys_lock();
 	{
 		event = priv_box_wait(box, data, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, box, event);
 	}
 	sys_unlock();
 
@@ -283,6 +276,7 @@ unsigned box_give( box_t *box, const void *data )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_GIVE, box, event);
 	}
 	sys_unlock();
 
@@ -317,6 +311,7 @@ unsigned box_sendFor( box_t *box, const void *data, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_box_send(box, data, delay, core_tsk_waitFor);
+		core_trc_event(TRC_GIVE, box, event);
 	}
 	sys_unlock();
 
@@ -332,6 +327,7 @@ unsigned box_sendUntil( box_t *box, const void *data, cnt_t time )
 	sys_lock();
 	{
 		event = priv_box_send(box, data, time, core_tsk_waitUntil);
+		core_trc_event(TRC_GIVE, box, event);
 	}
 	sys_unlock();
 
@@ -360,6 +356,7 @@ unsigned box_push( box_t *box, const void *data )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_GIVE, box, event);
 	}
 	sys_unlock();
 
@@ -38,9 +38,6 @@
 void mem_bind( mem_t *mem )
 /* -------------------------------------------------------------------------- */
 {
-	que_t  * ptr;
-	unsigned cnt;
-
 	assert(!port_isr_context());
 	assert(mem);
 	assert(mem->limit);
@@ -49,11 +46,9 @@ void mem_bind( mem_t *mem )
 
 	sys_lock();
 	{
-		ptr = mem->data;
-		cnt = mem->limit;
-
 		mem->lst.head.next = 0;
-		while (cnt--) { mem_give(mem, ++ptr); ptr += mem->size; }
+		mem->lst.tail = 0;
+		mem->spare = mem->limit;
 	}
 	sys_unlock();
 }
@@ -133,3 +128,72 @@ void mem_delete( mem_t *mem )
 }
 
 /* -------------------------------------------------------------------------- */
+static
+bool priv_mem_take( mem_t *mem, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	if (mem->spare == 0)
+		return false;
+
+	*data = mem->data + (mem->limit - mem->spare--) * (1 + mem->size) + 1;
+	core_trc_event(TRC_TAKE, mem, E_SUCCESS); // other events are traced by the list of the pool, at the same address
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mem_take( mem_t *mem, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(mem);
+	assert(data);
+
+	sys_lock();
+	{
+		event = priv_mem_take(mem, data) ? E_SUCCESS : lst_take(&mem->lst, data);
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mem_waitFor( mem_t *mem, void **data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_context());
+	assert(mem);
+	assert(data);
+
+	sys_lock();
+	{
+		event = priv_mem_take(mem, data) ? E_SUCCESS : lst_waitFor(&mem->lst, data, delay);
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mem_waitUntil( mem_t *mem, void **data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_context());
+	assert(mem);
+	assert(data);
+
+	sys_lock();
+	{
+		event = priv_mem_take(mem, data) ? E_SUCCESS : lst_waitUntil(&mem->lst, data, time);
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -89,8 +89,12 @@ void msg_kill( msg_t *msg )
 		msg->count = 0;
 		msg->head  = 0;
 		msg->tail  = 0;
+		msg->resv  = 0;
+		msg->peek  = 0;
+		msg->send  = false;
 
 		core_all_wakeup(&msg->obj.queue, E_STOPPED);
+		core_all_wakeup(&msg->wait, E_STOPPED);
 	}
 	sys_unlock();
 }
@@ -112,13 +116,7 @@ static
 void priv_msg_peek( msg_t *msg, char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
-	unsigned i = msg->head;
-
-	while (size--)
-	{
-		*data++ = msg->data[i++];
-		if (i >= msg->limit) i = 0;
-	}
+	core_buf_get(msg->data, msg->limit, msg->head, data, size);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -139,7 +137,7 @@ static
 unsigned priv_msg_space( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
-	return ((msg->count == 0 || msg->obj.queue == 0) && msg->limit - msg->count > sizeof(unsigned)) ? msg->limit - msg->count - sizeof(unsigned) : 0;
+	return (msg->resv == 0 && (msg->count == 0 || msg->obj.queue == 0) && msg->limit - msg->count > sizeof(unsigned)) ? msg->limit - msg->count - sizeof(unsigned) : 0;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -155,15 +153,8 @@ static
 void priv_msg_get( msg_t *msg, char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
-	unsigned i = msg->head;
-
 	msg->count -= size;
-	while (size--)
-	{
-		*data++ = msg->data[i++];
-		if (i >= msg->limit) i = 0;
-	}
-	msg->head = i;
+	msg->head = core_buf_get(msg->data, msg->limit, msg->head, data, size);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -171,15 +162,8 @@ static
 void priv_msg_put( msg_t *msg, const char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
-	unsigned i = msg->tail;
-
 	msg->count += size;
-	while (size--)
-	{
-		msg->data[i++] = *data++;
-		if (i >= msg->limit) i = 0;
-	}
-	msg->tail = i;
+	msg->tail = core_buf_put(msg->data, msg->limit, msg->tail, data, size);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -192,6 +176,30 @@ void priv_msg_skip( msg_t *msg, unsigned size )
 	if (msg->head >= msg->limit) msg->head -= msg->limit;
 }
 
+/* -------------------------------------------------------------------------- */
+static
+void priv_msg_keep( msg_t *msg, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	msg->count += size;
+	msg->tail  += size;
+	if (msg->tail >= msg->limit) msg->tail -= msg->limit;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_msg_region( msg_t *msg, unsigned i, unsigned size, rgn_t *rgn )
+/* -------------------------------------------------------------------------- */
+{
+	i += sizeof(unsigned);
+	if (i >= msg->limit) i -= msg->limit;
+
+	rgn->data[0] = &msg->data[i];
+	rgn->size[0] = (size < msg->limit - i) ? size : msg->limit - i;
+	rgn->data[1] = msg->data;
+	rgn->size[1] = size - rgn->size[0];
+}
+
 /* -------------------------------------------------------------------------- */
 static
 unsigned priv_msg_getSize( msg_t *msg )
@@ -218,34 +226,26 @@ void priv_msg_putSize( msg_t *msg, unsigned size )
 
 /* -------------------------------------------------------------------------- */
 static
-unsigned priv_msg_getUpdate( msg_t *msg, char *data, unsigned size )
+void priv_msg_putQueue( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
-	size = priv_msg_getSize(msg);
-	priv_msg_get(msg, data, size);
-
-	while (msg->obj.queue != 0 && msg->obj.queue->tmp.msg.size <= priv_msg_space(msg))
+	while (msg->obj.queue != 0 && msg->send && msg->obj.queue->tmp.msg.size <= priv_msg_space(msg))
 	{
 		priv_msg_putSize(msg, msg->obj.queue->tmp.msg.size);
 		priv_msg_put(msg, msg->obj.queue->tmp.msg.data.out, msg->obj.queue->tmp.msg.size);
 		msg->obj.queue->tmp.msg.size = 0;
 		core_tsk_wakeup(msg->obj.queue, E_SUCCESS);
 	}
-
-	return size;
 }
 
 /* -------------------------------------------------------------------------- */
 static
-void priv_msg_putUpdate( msg_t *msg, const char *data, unsigned size )
+void priv_msg_getQueue( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
-	assert(size <= priv_msg_space(msg));
-
-	priv_msg_putSize(msg, size);
-	priv_msg_put(msg, data, size);
+	unsigned size;
 
-	while (msg->obj.queue != 0)
+	while (msg->count > 0 && msg->obj.queue != 0)
 	{
 		if (msg->obj.queue->tmp.msg.size >= priv_msg_count(msg))
 		{
@@ -261,6 +261,121 @@ void priv_msg_putUpdate( msg_t *msg, const char *data, unsigned size )
 	}
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_getDirect( msg_t *msg, char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk = msg->obj.queue;
+
+	if (tsk == 0 || !msg->send || size < tsk->tmp.msg.size)
+		return 0;
+
+	size = tsk->tmp.msg.size;
+	memcpy(data, tsk->tmp.msg.data.out, size);
+	tsk->tmp.msg.size = 0;
+	core_tsk_wakeup(tsk, E_SUCCESS);
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_msg_putDirect( msg_t *msg, const char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+
+	if (msg->count > 0 || msg->send || size > priv_msg_limit(msg))
+		return false;
+
+	while ((tsk = msg->obj.queue) != 0)
+	{
+		if (tsk->tmp.msg.size >= size)
+		{
+			memcpy(tsk->tmp.msg.data.in, data, size);
+			tsk->tmp.msg.size -= size;
+			core_tsk_wakeup(tsk, E_SUCCESS);
+			return true;
+		}
+
+		core_tsk_wakeup(tsk, E_TIMEOUT);
+	}
+
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_msg_getWait( msg_t *msg )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * tsk;
+	unsigned size;
+
+	while ((tsk = msg->wait) != 0)
+	{
+		if (msg->count > 0)
+		{
+			if (tsk->tmp.msg.size >= priv_msg_count(msg))
+			{
+				size = priv_msg_getSize(msg);
+				priv_msg_get(msg, tsk->tmp.msg.data.in, size);
+				tsk->tmp.msg.size -= size;
+				core_tsk_wakeup(tsk, E_SUCCESS);
+				priv_msg_putQueue(msg);
+			}
+			else
+			{
+				core_tsk_wakeup(tsk, E_TIMEOUT);
+			}
+		}
+		else
+		if (msg->obj.queue != 0 && msg->send)
+		{
+			size = priv_msg_getDirect(msg, tsk->tmp.msg.data.in, tsk->tmp.msg.size);
+			tsk->tmp.msg.size -= size;
+			core_tsk_wakeup(tsk, size > 0 ? E_SUCCESS : E_TIMEOUT);
+		}
+		else
+		{
+			msg->send = false;
+			core_tsk_transfer(tsk, &msg->obj.queue);
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_getUpdate( msg_t *msg, char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	size = priv_msg_getSize(msg);
+	priv_msg_get(msg, data, size);
+	priv_msg_putQueue(msg);
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_putUpdate( msg_t *msg, const char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(size);
+
+	if (!priv_msg_putDirect(msg, data, size))
+	{
+		if (size > priv_msg_space(msg))
+			return 0;
+
+		priv_msg_putSize(msg, size);
+		priv_msg_put(msg, data, size);
+	}
+
+	return size;
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned msg_take( msg_t *msg, void *data, unsigned size )
 /* -------------------------------------------------------------------------- */
@@ -274,9 +389,14 @@ unsigned msg_take( msg_t *msg, void *data, unsigned size )
 	{
 		if (msg->count > 0)
 		{
-			if (size >= priv_msg_count(msg))
+			if (msg->peek == 0 && size >= priv_msg_count(msg))
 				len = priv_msg_getUpdate(msg, data, size);
 		}
+		else
+		{
+			len = priv_msg_getDirect(msg, data, size);
+		}
+		core_trc_event(TRC_TAKE, msg, len);
 	}
 	sys_unlock();
 
@@ -292,18 +412,32 @@ unsigned priv_msg_wait( msg_t *msg, char *data, unsigned size, cnt_t time, unsig
 	assert(msg);
 	assert(data);
 
-	if (msg->count > 0)
+	tsk_t  **que = &msg->wait;
+
+	if (msg->peek == 0)
 	{
-		if (size >= priv_msg_count(msg))
-			return priv_msg_getUpdate(msg, data, size);
-		return 0;
+		if (msg->count > 0)
+		{
+			if (size >= priv_msg_count(msg))
+				return priv_msg_getUpdate(msg, data, size);
+			return 0;
+		}
+
+		if (msg->obj.queue != 0 && msg->send)
+			return priv_msg_getDirect(msg, data, size);
+
+		que = &msg->obj.queue;
 	}
 
 	System.cur->tmp.msg.data.in = data;
 	System.cur->tmp.msg.size = size;
 
 	if (size > 0)
-		wait(&msg->obj.queue, time);
+	{
+		if (que == &msg->obj.queue)
+			msg->send = false;
+		wait(que, time);
+	}
 
 	return size - System.cur->tmp.msg.size;
 }
@@ -317,6 +451,7 @@ unsigned msg_waitFor( msg_t *msg, void *data, unsigned size, cnt_t delay )
 	sys_lock();
 	{
 		len = priv_msg_wait(msg, data, size, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, msg, len);
 	}
 	sys_unlock();
 
@@ -332,6 +467,7 @@ unsigned msg_waitUntil( msg_t *msg, void *data, unsigned size, cnt_t time )
 	sys_lock();
 	{
 		len = priv_msg_wait(msg, data, size, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, msg, len);
 	}
 	sys_unlock();
 
@@ -349,12 +485,9 @@ unsigned msg_give( msg_t *msg, const void *data, unsigned size )
 
 	sys_lock();
 	{
-		if (size <= priv_msg_space(msg))
-		{
-			if (size > 0)
-				priv_msg_putUpdate(msg, data, size);
-			len = size;
-		}
+		if (size > 0)
+			len = priv_msg_putUpdate(msg, data, size);
+		core_trc_event(TRC_GIVE, msg, len);
 	}
 	sys_unlock();
 
@@ -370,18 +503,17 @@ unsigned priv_msg_send( msg_t *msg, const char *data, unsigned size, cnt_t time,
 	assert(msg);
 	assert(data);
 
-	if (size <= priv_msg_space(msg))
-	{
-		if (size > 0)
-			priv_msg_putUpdate(msg, data, size);
+	if (size == 0 || priv_msg_putUpdate(msg, data, size) == size)
 		return size;
-	}
 
 	System.cur->tmp.msg.data.out = data;
 	System.cur->tmp.msg.size = size;
 
 	if (size <= priv_msg_limit(msg))
+	{
+		msg->send = true;
 		wait(&msg->obj.queue, time);
+	}
 
 	return size - System.cur->tmp.msg.size;
 }
@@ -395,6 +527,7 @@ unsigned msg_sendFor( msg_t *msg, const void *data, unsigned size, cnt_t delay )
 	sys_lock();
 	{
 		len = priv_msg_send(msg, data, size, delay, core_tsk_waitFor);
+		core_trc_event(TRC_GIVE, msg, len);
 	}
 	sys_unlock();
 
@@ -410,6 +543,7 @@ unsigned msg_sendUntil( msg_t *msg, const void *data, unsigned size, cnt_t time
 	sys_lock();
 	{
 		len = priv_msg_send(msg, data, size, time, core_tsk_waitUntil);
+		core_trc_event(TRC_GIVE, msg, len);
 	}
 	sys_unlock();
 
@@ -427,13 +561,86 @@ unsigned msg_push( msg_t *msg, const void *data, unsigned size )
 
 	sys_lock();
 	{
-		if ((msg->count == 0 || msg->obj.queue == 0) && size <= priv_msg_limit(msg))
+		if ((msg->count == 0 || msg->obj.queue == 0) && msg->resv == 0 && size <= priv_msg_limit(msg) &&
+		    (msg->peek == 0 || size <= priv_msg_space(msg)))
 		{
 			while (size > priv_msg_space(msg))
 				priv_msg_skip(msg, priv_msg_getSize(msg));
 			if (size > 0)
-				priv_msg_putUpdate(msg, data, size);
-			len = size;
+				len = priv_msg_putUpdate(msg, data, size);
+		}
+		core_trc_event(TRC_GIVE, msg, len);
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_reserve( msg_t *msg, unsigned size, rgn_t *rgn )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len = 0;
+
+	assert(msg);
+	assert(rgn);
+
+	sys_lock();
+	{
+		if (size > 0 && size <= priv_msg_space(msg))
+		{
+			priv_msg_region(msg, msg->tail, size, rgn);
+			msg->resv = len = size;
+		}
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+void msg_commit( msg_t *msg, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(msg);
+
+	sys_lock();
+	{
+		if (msg->resv > 0)
+		{
+			assert(size <= msg->resv);
+
+			msg->resv = 0;
+			if (size > 0)
+			{
+				priv_msg_putSize(msg, size);
+				priv_msg_keep(msg, size);
+			}
+			if (msg->send)
+				priv_msg_putQueue(msg);
+			else
+				priv_msg_getQueue(msg);
+		}
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_peek( msg_t *msg, rgn_t *rgn )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len = 0;
+
+	assert(msg);
+	assert(rgn);
+
+	sys_lock();
+	{
+		if (msg->count > 0 && msg->peek == 0)
+		{
+			len = priv_msg_count(msg);
+			priv_msg_region(msg, msg->head, len, rgn);
+			msg->peek = len;
 		}
 	}
 	sys_unlock();
@@ -441,6 +648,25 @@ unsigned msg_push( msg_t *msg, const void *data, unsigned size )
 	return len;
 }
 
+/* -------------------------------------------------------------------------- */
+void msg_release( msg_t *msg )
+/* -------------------------------------------------------------------------- */
+{
+	assert(msg);
+
+	sys_lock();
+	{
+		if (msg->peek > 0)
+		{
+			priv_msg_skip(msg, sizeof(unsigned) + msg->peek);
+			msg->peek = 0;
+			priv_msg_putQueue(msg);
+			priv_msg_getWait(msg);
+		}
+	}
+	sys_unlock();
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned msg_count( msg_t *msg )
 /* -------------------------------------------------------------------------- */
@@ -35,7 +35,13 @@
 #include "osalloc.h"
 
 /* -------------------------------------------------------------------------- */
-void mtx_init( mtx_t *mtx )
+// slab cache of mtx_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(mtx_t));
+
+/* -------------------------------------------------------------------------- */
+void mtx_init( mtx_t *mtx, unsigned ceiling )
 /* -------------------------------------------------------------------------- */
 {
 	assert(!port_isr_context());
@@ -46,12 +52,14 @@ void mtx_init( mtx_t *mtx )
 		memset(mtx, 0, sizeof(mtx_t));
 
 		core_obj_init(&mtx->obj);
+
+		mtx->ceil = ceiling;
 	}
 	sys_unlock();
 }
 
 /* -------------------------------------------------------------------------- */
-mtx_t *mtx_create( void )
+mtx_t *mtx_create( unsigned ceiling )
 /* -------------------------------------------------------------------------- */
 {
 	mtx_t *mtx;
@@ -60,59 +68,15 @@ mtx_t *mtx_create( void )
 
 	sys_lock();
 	{
-		mtx = sys_alloc(sizeof(mtx_t));
-		mtx_init(mtx);
-		mtx->obj.res = mtx;
+		mtx = sys_slabAlloc(&Slab);
+		mtx_init(mtx, ceiling);
+		mtx->obj.res = SLB_RES(mtx);
 	}
 	sys_unlock();
 
 	return mtx;
 }
 
-/* -------------------------------------------------------------------------- */
-static
-void priv_mtx_link( mtx_t *mtx, tsk_t *tsk )
-/* -------------------------------------------------------------------------- */
-{
-	assert(mtx);
-
-	mtx->owner = tsk;
-
-	if (tsk)
-	{
-		mtx->list = tsk->mtx.list;
-		tsk->mtx.list = mtx;
-	}
-}
-
-/* -------------------------------------------------------------------------- */
-static
-void priv_mtx_unlink( mtx_t *mtx )
-/* -------------------------------------------------------------------------- */
-{
-	tsk_t *tsk;
-	mtx_t *lst;
-
-	assert(mtx);
-
-	if (mtx->owner)
-	{
-		tsk = mtx->owner;
-
-		if (tsk->mtx.list == mtx)
-			tsk->mtx.list = mtx->list;
-
-		for (lst = tsk->mtx.list; lst; lst = lst->list)
-			if (lst->list == mtx)
-				lst->list = mtx->list;
-
-		mtx->list  = 0;
-		mtx->owner = 0;
-
-		core_tsk_prio(tsk, tsk->basic);
-	}
-}
-
 /* -------------------------------------------------------------------------- */
 void mtx_kill( mtx_t *mtx )
 /* -------------------------------------------------------------------------- */
@@ -122,7 +86,7 @@ void mtx_kill( mtx_t *mtx )
 
 	sys_lock();
 	{
-		priv_mtx_unlink(mtx);
+		core_mtx_unlink(mtx);
 
 		mtx->count = 0;
 
@@ -138,7 +102,7 @@ void mtx_delete( mtx_t *mtx )
 	sys_lock();
 	{
 		mtx_kill(mtx);
-		sys_free(mtx->obj.res);
+		sys_slabFree(&mtx->obj);
 	}
 	sys_unlock();
 }
@@ -153,7 +117,7 @@ unsigned priv_mtx_wait( mtx_t *mtx, cnt_t time, unsigned(*wait)(tsk_t**,cnt_t) )
 
 	if (mtx->owner == 0)
 	{
-		priv_mtx_link(mtx, System.cur);
+		core_mtx_link(mtx, System.cur);
 		return E_SUCCESS;
 	}
 
@@ -161,12 +125,18 @@ unsigned priv_mtx_wait( mtx_t *mtx, cnt_t time, unsigned(*wait)(tsk_t**,cnt_t) )
 	{
 		unsigned event;
 
-		if (mtx->owner->prio < System.cur->prio)
-			core_tsk_prio(mtx->owner, System.cur->prio);
+		core_mtx_prio(mtx, System.cur->prio);
 
-		System.cur->mtx.tree = mtx->owner;
+		System.cur->mtx.tree = mtx;
 		event = wait(&mtx->obj.queue, time);
-		System.cur->mtx.tree = 0;
+
+		// 'mtx.tree' is cleared when the task is woken up, the mutex may have been deleted since then
+		if (System.cur->mtx.tree)
+		//	the task hasn't been queued (immediate timeout), so the lent priority is dropped here
+		{
+			System.cur->mtx.tree = 0;
+			core_mtx_prio(mtx, 0);
+		}
 
 		return event;
 	}
@@ -189,6 +159,7 @@ unsigned mtx_waitFor( mtx_t *mtx, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_mtx_wait(mtx, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, mtx, event);
 	}
 	sys_unlock();
 
@@ -204,6 +175,7 @@ unsigned mtx_waitUntil( mtx_t *mtx, cnt_t time )
 	sys_lock();
 	{
 		event = priv_mtx_wait(mtx, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, mtx, event);
 	}
 	sys_unlock();
 
@@ -233,10 +205,11 @@ unsigned mtx_give( mtx_t *mtx )
 		}
 		else
 		{
-			priv_mtx_unlink(mtx);
-			priv_mtx_link(mtx, core_one_wakeup(&mtx->obj.queue, E_SUCCESS));
+			core_mtx_unlink(mtx);
+			core_mtx_link(mtx, core_one_wakeup(&mtx->obj.queue, E_SUCCESS));
 			event = E_SUCCESS;
 		}
+		core_trc_event(TRC_GIVE, mtx, event);
 	}
 	sys_unlock();
 
@@ -33,6 +33,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of sem_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(sem_t));
+
 /* -------------------------------------------------------------------------- */
 void sem_init( sem_t *sem, unsigned init, unsigned limit )
 /* -------------------------------------------------------------------------- */
@@ -63,9 +69,9 @@ sem_t *sem_create( unsigned init, unsigned limit )
 
 	sys_lock();
 	{
-		sem = sys_alloc(sizeof(sem_t));
+		sem = sys_slabAlloc(&Slab);
 		sem_init(sem, init, limit);
-		sem->obj.res = sem;
+		sem->obj.res = SLB_RES(sem);
 	}
 	sys_unlock();
 
@@ -95,7 +101,7 @@ void sem_delete( sem_t *sem )
 	sys_lock();
 	{
 		sem_kill(sem);
-		sys_free(sem->obj.res);
+		sys_slabFree(&sem->obj);
 	}
 	sys_unlock();
 }
@@ -121,6 +127,7 @@ unsigned sem_take( sem_t *sem )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_TAKE, sem, event);
 	}
 	sys_unlock();
 
@@ -155,6 +162,7 @@ unsigned sem_waitFor( sem_t *sem, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_sem_wait(sem, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, sem, event);
 	}
 	sys_unlock();
 
@@ -170,6 +178,7 @@ unsigned sem_waitUntil( sem_t *sem, cnt_t time )
 	sys_lock();
 	{
 		event = priv_sem_wait(sem, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, sem, event);
 	}
 	sys_unlock();
 
@@ -197,6 +206,7 @@ unsigned sem_give( sem_t *sem )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_GIVE, sem, event);
 	}
 	sys_unlock();
 
@@ -231,6 +241,7 @@ unsigned sem_sendFor( sem_t *sem, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_sem_send(sem, delay, core_tsk_waitFor);
+		core_trc_event(TRC_GIVE, sem, event);
 	}
 	sys_unlock();
 
@@ -246,6 +257,7 @@ unsigned sem_sendUntil( sem_t *sem, cnt_t time )
 	sys_lock();
 	{
 		event = priv_sem_send(sem, time, core_tsk_waitUntil);
+		core_trc_event(TRC_GIVE, sem, event);
 	}
 	sys_unlock();
 
@@ -253,3 +265,13 @@ unsigned sem_sendUntil( sem_t *sem, cnt_t time )
 }
 
 /* -------------------------------------------------------------------------- */
+
+#if OS_ISR_QUEUE
+
+/* -------------------------------------------------------------------------- */
+_ISR_ASYNC( sem_give, sem_t ) // unsigned sem_giveAsync( sem_t *sem )
+/* -------------------------------------------------------------------------- */
+
+#endif
+
+/* -------------------------------------------------------------------------- */
@@ -33,6 +33,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of sig_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(sig_t));
+
 /* -------------------------------------------------------------------------- */
 void sig_init( sig_t *sig, bool type )
 /* -------------------------------------------------------------------------- */
@@ -61,9 +67,9 @@ sig_t *sig_create( bool type )
 
 	sys_lock();
 	{
-		sig = sys_alloc(sizeof(sig_t));
+		sig = sys_slabAlloc(&Slab);
 		sig_init(sig, type);
-		sig->obj.res = sig;
+		sig->obj.res = SLB_RES(sig);
 	}
 	sys_unlock();
 
@@ -93,7 +99,7 @@ void sig_delete( sig_t *sig )
 	sys_lock();
 	{
 		sig_kill(sig);
-		sys_free(sig->obj.res);
+		sys_slabFree(&sig->obj);
 	}
 	sys_unlock();
 }
@@ -117,6 +123,7 @@ unsigned sig_take( sig_t *sig )
 		{
 			event = E_TIMEOUT;
 		}
+		core_trc_event(TRC_TAKE, sig, event);
 	}
 	sys_unlock();
 
@@ -149,6 +156,7 @@ unsigned sig_waitFor( sig_t *sig, cnt_t delay )
 	sys_lock();
 	{
 		event = priv_sig_wait(sig, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, sig, event);
 	}
 	sys_unlock();
 
@@ -164,6 +172,7 @@ unsigned sig_waitUntil( sig_t *sig, cnt_t time )
 	sys_lock();
 	{
 		event = priv_sig_wait(sig, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, sig, event);
 	}
 	sys_unlock();
 
@@ -187,6 +196,7 @@ void sig_give( sig_t *sig )
 			sig->flag = true;
 			core_all_wakeup(&sig->obj.queue, E_SUCCESS);
 		}
+		core_trc_event(TRC_GIVE, sig, E_SUCCESS);
 	}
 	sys_unlock();
 }
@@ -201,3 +211,13 @@ void sig_clear( sig_t *sig )
 }
 
 /* -------------------------------------------------------------------------- */
+
+#if OS_ISR_QUEUE
+
+/* -------------------------------------------------------------------------- */
+_ISR_ASYNC( sig_give, sig_t ) // unsigned sig_giveAsync( sig_t *sig )
+/* -------------------------------------------------------------------------- */
+
+#endif
+
+/* -------------------------------------------------------------------------- */
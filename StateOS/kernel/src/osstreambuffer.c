@@ -136,15 +136,8 @@ static
 void priv_stm_get( stm_t *stm, char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
-	unsigned i = stm->head;
-
 	stm->count -= size;
-	while (size--)
-	{
-		*data++ = stm->data[i++];
-		if (i >= stm->limit) i = 0;
-	}
-	stm->head = i;
+	stm->head = core_buf_get(stm->data, stm->limit, stm->head, data, size);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -152,15 +145,8 @@ static
 void priv_stm_put( stm_t *stm, const char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
-	unsigned i = stm->tail;
-
 	stm->count += size;
-	while (size--)
-	{
-		stm->data[i++] = *data++;
-		if (i >= stm->limit) i = 0;
-	}
-	stm->tail = i;
+	stm->tail = core_buf_put(stm->data, stm->limit, stm->tail, data, size);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -229,6 +215,7 @@ unsigned stm_take( stm_t *stm, void *data, unsigned size )
 				size = priv_stm_getUpdate(stm, data, size);
 			len = size;
 		}
+		core_trc_event(TRC_TAKE, stm, len);
 	}
 	sys_unlock();
 
@@ -269,6 +256,7 @@ unsigned stm_waitFor( stm_t *stm, void *data, unsigned size, cnt_t delay )
 	sys_lock();
 	{
 		len = priv_stm_wait(stm, data, size, delay, core_tsk_waitFor);
+		core_trc_event(TRC_TAKE, stm, len);
 	}
 	sys_unlock();
 
@@ -284,6 +272,7 @@ unsigned stm_waitUntil( stm_t *stm, void *data, unsigned size, cnt_t time )
 	sys_lock();
 	{
 		len = priv_stm_wait(stm, data, size, time, core_tsk_waitUntil);
+		core_trc_event(TRC_TAKE, stm, len);
 	}
 	sys_unlock();
 
@@ -307,6 +296,7 @@ unsigned stm_give( stm_t *stm, const void *data, unsigned size )
 				priv_stm_putUpdate(stm, data, size);
 			len = size;
 		}
+		core_trc_event(TRC_GIVE, stm, len);
 	}
 	sys_unlock();
 
@@ -347,6 +337,7 @@ unsigned stm_sendFor( stm_t *stm, const void *data, unsigned size, cnt_t delay )
 	sys_lock();
 	{
 		len = priv_stm_send(stm, data, size, delay, core_tsk_waitFor);
+		core_trc_event(TRC_GIVE, stm, len);
 	}
 	sys_unlock();
 
@@ -362,6 +353,7 @@ unsigned stm_sendUntil( stm_t *stm, const void *data, unsigned size, cnt_t time
 	sys_lock();
 	{
 		len = priv_stm_send(stm, data, size, time, core_tsk_waitUntil);
+		core_trc_event(TRC_GIVE, stm, len);
 	}
 	sys_unlock();
 
@@ -387,6 +379,7 @@ unsigned stm_push( stm_t *stm, const void *data, unsigned size )
 				priv_stm_putUpdate(stm, data, size);
 			len = size;
 		}
+		core_trc_event(TRC_GIVE, stm, len);
 	}
 	sys_unlock();
 
@@ -42,6 +42,7 @@ void tsk_init( tsk_t *tsk, unsigned prio, fun_t *state, stk_t *stack, unsigned s
 	assert(state);
 	assert(stack);
 	assert(size);
+	assert(STK_MIN(size) == size);
 
 	sys_lock();
 	{
@@ -71,6 +72,8 @@ tsk_t *wrk_create( unsigned prio, fun_t *state, unsigned size )
 	assert(state);
 	assert(size);
 
+	size = STK_MIN(size);
+
 	sys_lock();
 	{
 		tsk = sys_alloc(SEG_OVER(sizeof(tsk_t)) + size);
@@ -95,6 +98,9 @@ void tsk_start( tsk_t *tsk )
 		if (tsk->hdr.id == ID_STOPPED)
 		{
 			core_ctx_init(tsk);
+#if OS_EDF
+			tsk->edf.due = core_sys_time() + tsk->edf.dline;
+#endif
 			core_tsk_insert(tsk);
 		}
 	}
@@ -116,6 +122,9 @@ void tsk_startFrom( tsk_t *tsk, fun_t *state )
 			tsk->state = state;
 
 			core_ctx_init(tsk);
+#if OS_EDF
+			tsk->edf.due = core_sys_time() + tsk->edf.dline;
+#endif
 			core_tsk_insert(tsk);
 		}
 	}
@@ -130,6 +139,7 @@ void tsk_stop( void )
 	assert(!System.cur->mtx.list);
 
 	port_set_lock();
+	core_lck_enterHere();
 
 	if (System.cur->join != DETACHED)
 		core_tsk_wakeup(System.cur->join, E_SUCCESS);
@@ -145,6 +155,8 @@ void tsk_stop( void )
 void tsk_kill( tsk_t *tsk )
 /* -------------------------------------------------------------------------- */
 {
+	mtx_t *mtx;
+
 	assert(!port_isr_context());
 	assert(tsk);
 
@@ -152,6 +164,7 @@ void tsk_kill( tsk_t *tsk )
 	{
 		if (tsk->hdr.id != ID_STOPPED)
 		{
+			mtx = tsk->mtx.tree;
 			tsk->mtx.tree = 0;
 			while (tsk->mtx.list)
 				mtx_kill(tsk->mtx.list);
@@ -168,6 +181,8 @@ void tsk_kill( tsk_t *tsk )
 			{
 				core_tsk_unlink((tsk_t *)tsk, E_STOPPED);
 				core_tmr_remove((tmr_t *)tsk);
+				if (mtx)
+					core_mtx_prio(mtx, 0);
 			}
 		}
 	}
@@ -263,6 +278,7 @@ void tsk_flip( fun_t *state )
 	assert(state);
 
 	port_set_lock();
+	core_lck_enterHere();
 
 	System.cur->state = state;
 
@@ -270,6 +286,150 @@ void tsk_flip( fun_t *state )
 	core_tsk_flip((void *)STK_CROP(System.cur->stack, System.cur->size));
 }
 
+/* -------------------------------------------------------------------------- */
+void tsk_setQuantum( tsk_t *tsk, cnt_t quantum )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_context());
+	assert(tsk);
+
+	sys_lock();
+	{
+		tsk->quant = quantum;
+	}
+	sys_unlock();
+}
+
+#if OS_CPU_STATS
+
+/* -------------------------------------------------------------------------- */
+unsigned tsk_getLoad( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	uint64_t time, base;
+
+	assert(!port_isr_context());
+	assert(tsk);
+
+	sys_lock();
+	{
+		core_cpu_update();
+
+		time = tsk->cpu.time - tsk->cpu.mark;
+		base = System.cpu.time - tsk->cpu.base;
+
+		tsk->cpu.mark = tsk->cpu.time;
+		tsk->cpu.base = System.cpu.time;
+	}
+	sys_unlock();
+
+	return base ? (unsigned)(time * 1000 / base) : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+uint64_t tsk_getTime( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	uint64_t time;
+
+	assert(!port_isr_context());
+	assert(tsk);
+
+	sys_lock();
+	{
+		core_cpu_update();
+
+		time = tsk->cpu.time;
+	}
+	sys_unlock();
+
+	return time;
+}
+
+#endif
+
+#if OS_STACK_STATS
+
+// return the task following 'tsk' in the queue of tasks in state 'id' (ID_READY or ID_DELAYED)
+// the queue of ready tasks begins and ends with IDLE, the queue of delayed tasks with WAIT
+
+/* -------------------------------------------------------------------------- */
+static
+tsk_t *priv_tsk_next( tsk_t *tsk, unsigned id )
+/* -------------------------------------------------------------------------- */
+{
+	tmr_t *tmr = (tmr_t *)tsk;
+
+	if (id == ID_READY)
+		return tsk->hdr.next;
+
+	do tmr = core_tmr_next(tmr);
+	while (tmr != &WAIT && tmr->hdr.id != ID_DELAYED);
+
+	return (tsk_t *)tmr;
+}
+
+/* -------------------------------------------------------------------------- */
+void tsk_stackReport( void (*report)( tsk_t *tsk, unsigned used ) )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * head = &IDLE;    // head of the walked queue
+	tsk_t  * tsk  = 0;        // cursor, the last reported task
+	unsigned id   = ID_READY; // state of the tasks in the walked queue
+	unsigned num  = 0;        // position of the cursor in the walked queue
+	unsigned cnt;
+	void   * stack = 0;
+	size_t   size  = 0;
+
+	assert(!port_isr_context());
+	assert(report);
+
+	// the queues are walked once, from the cursor: IDLE, ready tasks, delayed tasks
+	// only the next task and its stack are taken under the kernel lock
+	// the stack is scanned and reported outside of the lock
+	for (;;)
+	{
+		sys_lock();
+		{
+			if (tsk == 0)
+			{
+				tsk = &IDLE;
+			}
+			else
+			{
+				if (tsk != head && tsk->hdr.id != id)
+				// the cursor has left the queue while the lock was released, continue from the task preceding it
+					for (tsk = head, cnt = num - 1; cnt > 0 && priv_tsk_next(tsk, id) != head; cnt--)
+						tsk = priv_tsk_next(tsk, id);
+
+				tsk = priv_tsk_next(tsk, id);
+				if (tsk == &IDLE)
+				{
+					head = (tsk_t *)&WAIT;
+					id   = ID_DELAYED;
+					num  = 0;
+					tsk  = priv_tsk_next(head, id);
+				}
+				num++;
+			}
+
+			if (tsk != (tsk_t *)&WAIT)
+			{
+				stack = tsk->stack;
+				size  = tsk->size;
+			}
+		}
+		sys_unlock();
+
+		if (tsk == (tsk_t *)&WAIT)
+			break;
+
+		report(tsk, core_stk_used(stack, size));
+	}
+}
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 void tsk_prio( unsigned prio )
 /* -------------------------------------------------------------------------- */
@@ -284,6 +444,27 @@ void tsk_prio( unsigned prio )
 	sys_unlock();
 }
 
+#if OS_EDF
+
+/* -------------------------------------------------------------------------- */
+void tsk_setDeadline( cnt_t deadline )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *cur = System.cur;
+
+	assert(!port_isr_context());
+
+	sys_lock();
+	{
+		cur->edf.dline = deadline;
+		cur->edf.due   = core_sys_time() + deadline;
+		core_ctx_switch();
+	}
+	sys_unlock();
+}
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 static
 unsigned priv_tsk_wait( unsigned flags, cnt_t time, unsigned(*wait)(tsk_t**,cnt_t) )
@@ -404,3 +585,13 @@ unsigned tsk_resume( tsk_t *tsk )
 }
 
 /* -------------------------------------------------------------------------- */
+
+#if OS_ISR_QUEUE
+
+/* -------------------------------------------------------------------------- */
+_ISR_ASYNC_ARG( tsk_give, tsk_t ) // unsigned tsk_giveAsync( tsk_t *tsk, unsigned flags )
+/* -------------------------------------------------------------------------- */
+
+#endif
+
+/* -------------------------------------------------------------------------- */
@@ -33,6 +33,12 @@
 #include "inc/oscriticalsection.h"
 #include "osalloc.h"
 
+/* -------------------------------------------------------------------------- */
+// slab cache of tmr_t objects created at runtime
+
+static
+slb_t Slab = _SLB_INIT(sizeof(tmr_t));
+
 /* -------------------------------------------------------------------------- */
 void tmr_init( tmr_t *tmr, fun_t *state )
 /* -------------------------------------------------------------------------- */
@@ -61,9 +67,9 @@ tmr_t *tmr_create( fun_t *state )
 
 	sys_lock();
 	{
-		tmr = sys_alloc(sizeof(tmr_t));
+		tmr = sys_slabAlloc(&Slab);
 		tmr_init(tmr, state);
-		tmr->hdr.obj.res = tmr;
+		tmr->hdr.obj.res = SLB_RES(tmr);
 	}
 	sys_unlock();
 
@@ -95,7 +101,7 @@ void tmr_delete( tmr_t *tmr )
 	sys_lock();
 	{
 		tmr_kill(tmr);
-		sys_free(tmr->hdr.obj.res);
+		sys_slabFree(&tmr->hdr.obj);
 	}
 	sys_unlock();
 }
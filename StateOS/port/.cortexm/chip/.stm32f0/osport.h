@@ -115,14 +115,23 @@ void port_ctx_switch( void )
 
 /* -------------------------------------------------------------------------- */
 // reset context switch indicator
+// 'slice' is the time slice of the next task (in ticks)
 
 __STATIC_INLINE
-void port_ctx_reset( void )
+void port_ctx_reset( uint32_t slice )
 {
-#if HW_TIMER_SIZE
-	#if OS_ROBIN
-	SysTick->VAL = 0;
+#if HW_TIMER_SIZE && OS_ROBIN
+	#if (CPU_FREQUENCY)/(OS_ROBIN)-1 <= SysTick_LOAD_RELOAD_Msk
+	const uint32_t cnt = (CPU_FREQUENCY)/(OS_FREQUENCY); // number of SysTick counts per tick
+	#else
+	const uint32_t cnt = (ST_FREQUENCY)/(OS_FREQUENCY);  // number of SysTick counts per tick
 	#endif
+	if (slice > (SysTick_LOAD_RELOAD_Msk+1)/cnt)
+		slice = (SysTick_LOAD_RELOAD_Msk+1)/cnt;
+	SysTick->LOAD = slice * cnt - 1;
+	SysTick->VAL  = 0;
+#else
+	(void) slice;
 #endif
 }
 
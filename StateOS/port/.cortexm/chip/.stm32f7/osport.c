@@ -135,6 +135,60 @@ void port_sys_init( void )
 
 #endif//HW_TIMER_SIZE
 
+	#if (OS_CPU_STATS || OS_LOCK_STATS || OS_TRACE) && (__CORTEX_M >= 3)
+
+/******************************************************************************
+ Configuration of cycle counter for CPU time accounting, lock windows profiling and event trace
+*******************************************************************************/
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	#if __CORTEX_M == 7
+	DWT->LAR = 0xC5ACCE55U; // unlock access to DWT registers
+	#endif
+	DWT->CYCCNT = 0U;
+	DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+	#endif//OS_CPU_STATS || OS_LOCK_STATS || OS_TRACE
+
+	#if OS_STACK_STATS && defined(ISR_STACK)
+
+/******************************************************************************
+ Painting of the stack of interrupt handlers for the high-water mark
+ The main stack is not used yet, the main task uses the process stack
+*******************************************************************************/
+
+	core_stk_paint(ISR_STACK, ISR_STACK_SIZE);
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+	#endif//OS_STACK_STATS
+
+	#if OS_MPU_GUARD
+
+/******************************************************************************
+ Configuration of MPU for the stack guard
+ The default memory map is used for all other accesses in privileged mode
+*******************************************************************************/
+
+	MPU->RNR   = MPU_GUARD_REGION;
+	MPU->RASR  = 0U;
+	MPU->CTRL |= MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+	SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+	__DSB();
+	__ISB();
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+	#endif//OS_MPU_GUARD
+
 /******************************************************************************
  Configuration of interrupt for context switch
 *******************************************************************************/
@@ -164,6 +218,111 @@ void SysTick_Handler( void )
  End of the handler
 *******************************************************************************/
 
+	#if OS_TICKLESS_IDLE
+
+/******************************************************************************
+ Non-tick-less mode with tick suppression: put the core to sleep
+ SysTick is reloaded to wake up the core at the nearest timers' event
+ Interrupts are masked with PRIMASK only, so any of them can wake up the core
+*******************************************************************************/
+
+	#if (CPU_FREQUENCY)/(OS_FREQUENCY)-1 <= SysTick_LOAD_RELOAD_Msk
+	#define ST_RELOAD ((CPU_FREQUENCY)/(OS_FREQUENCY))
+	#else
+	#define ST_RELOAD ((ST_FREQUENCY)/(OS_FREQUENCY))
+	#endif
+	#define ST_TICKS  ((SysTick_LOAD_RELOAD_Msk+1)/(ST_RELOAD))
+	#define ST_MARGIN   16 /* minimal number of SysTick counts to reload */
+
+static
+void priv_tck_reload( uint32_t cnt )
+{
+	SysTick->LOAD  = cnt - 1;
+	SysTick->VAL   = 0U;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	while (SysTick->VAL == 0U); // wait until SysTick is reloaded
+	SysTick->LOAD  = (ST_RELOAD) - 1;
+}
+
+cnt_t port_tck_sleep( cnt_t ticks )
+{
+	uint32_t lck = __get_PRIMASK();
+	uint32_t ctl, cnt, tmp = 0;
+	cnt_t    tck = 0;
+
+	__disable_irq();
+	#if OS_LOCK_LEVEL && (__CORTEX_M >= 3)
+	port_clr_lock();
+	#endif
+
+	if (ticks > ST_TICKS)
+		ticks = ST_TICKS;
+
+	if (ticks > 1)
+	{
+		SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+		cnt = SysTick->VAL;
+
+		if (cnt > ST_MARGIN && (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) == 0)
+		{
+			tmp = cnt + (ticks - 1) * (ST_RELOAD);
+			SysTick->LOAD  = tmp - 1;
+			SysTick->VAL   = 0U;
+			SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		}
+		else
+		{
+			SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+			ticks = 0;
+		}
+	}
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	if (ticks > 1)
+	{
+		ctl = SysTick->CTRL;
+		SysTick->CTRL = ctl & ~SysTick_CTRL_ENABLE_Msk;
+		cnt = SysTick->VAL;
+
+		if ((ctl & SysTick_CTRL_COUNTFLAG_Msk) || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+		{
+			// the last tick will be counted by the pending SysTick interrupt
+			tmp  = cnt ? tmp - cnt : 0;
+			tck  = ticks - 1 + tmp / (ST_RELOAD);
+			cnt  = (ST_RELOAD) - tmp % (ST_RELOAD);
+		}
+		else
+		{
+			// woken up by another interrupt
+			tck  = ticks - 1 - cnt / (ST_RELOAD);
+			cnt  = cnt % (ST_RELOAD);
+			if (cnt == 0)
+				cnt = (ST_RELOAD), tck++;
+		}
+
+		if (cnt < ST_MARGIN)
+			cnt += (ST_RELOAD), tck++;
+
+		priv_tck_reload(cnt);
+	}
+
+	#if OS_LOCK_LEVEL && (__CORTEX_M >= 3)
+	port_set_lock();
+	#endif
+	__set_PRIMASK(lck);
+
+	return tck;
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
+
+	#endif//OS_TICKLESS_IDLE
+
 #else //HW_TIMER_SIZE
 
 /******************************************************************************
@@ -102,6 +102,17 @@ typedef uint64_t              stk_t;
 extern  stk_t               __initial_sp[];
 #define MAIN_TOP            __initial_sp
 
+// stack of interrupt handlers (main stack), when it is separated from the stack of the main task (process stack)
+// main_stack_size and proc_stack_size are the definitions of the startup file and the linker script
+
+#if defined(main_stack_size) && defined(proc_stack_size)
+#if (main_stack_size) > 0 && (proc_stack_size) > 0
+extern  stk_t               __initial_msp[];
+#define ISR_STACK_SIZE    ((((main_stack_size)+7)&(~7)))
+#define ISR_STACK         ((stk_t *)((size_t)__initial_msp - (ISR_STACK_SIZE)))
+#endif
+#endif
+
 /* -------------------------------------------------------------------------- */
 // task context
 
@@ -204,6 +215,98 @@ void * port_get_sp( void )
 
 #define port_set_barrier()  __ISB()
 
+/* -------------------------------------------------------------------------- */
+// clear pending context switch request
+
+__STATIC_INLINE
+void port_ctx_clear( void )
+{
+	SCB->ICSR = SCB_ICSR_PENDSVCLR_Msk;
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically increment the counter '*cnt' unless it is equal to 'lim'
+// return the previous value of the counter
+
+__STATIC_INLINE
+unsigned port_cnt_inc( volatile unsigned *cnt, unsigned lim )
+{
+	unsigned val;
+#if __CORTEX_M > 0
+	do if ((val = __LDREXW((volatile uint32_t *)cnt)) == lim) { __CLREX(); break; }
+	while (__STREXW(val + 1, (volatile uint32_t *)cnt));
+#else
+	uint32_t lck = __get_PRIMASK();
+	__disable_irq();
+	val = *cnt;
+	if (val != lim)
+		*cnt = val + 1;
+	__set_PRIMASK(lck);
+#endif
+	return val;
+}
+
+/* -------------------------------------------------------------------------- */
+// return time stamp for CPU time accounting, lock windows profiling and event trace
+// DWT cycle counter on Cortex-M3 and later, system timer otherwise
+// CPU_TIME_FREQUENCY is the frequency of the time stamp counter
+
+#if OS_CPU_STATS || OS_LOCK_STATS || OS_TRACE
+
+#if __CORTEX_M >= 3
+
+#define CPU_TIME_FREQUENCY (CPU_FREQUENCY)
+
+__STATIC_INLINE
+uint32_t port_cpu_time( void )
+{
+	return DWT->CYCCNT;
+}
+
+#else
+
+#define CPU_TIME_FREQUENCY (OS_FREQUENCY)
+
+#define port_cpu_time()    ((uint32_t)core_sys_time())
+
+#endif
+
+#endif//OS_CPU_STATS || OS_LOCK_STATS || OS_TRACE
+
+/* -------------------------------------------------------------------------- */
+// MPU stack guard
+// region MPU_GUARD_REGION is a read-only and non-executable guard at the bottom of the stack of the current task
+// the guard is the first block of size OS_MPU_GUARD aligned to its size inside the stack area
+// so any write beyond the stack generates MemManage fault before the memory below the stack is damaged
+// the guard is disabled for tasks with too small stacks (smaller than two blocks) or unknown stacks (main task)
+
+#if OS_MPU_GUARD
+
+#if     __CORTEX_M < 3 || !defined(__MPU_PRESENT) || (__MPU_PRESENT == 0)
+#error  osconfig.h: OS_MPU_GUARD requires Cortex-M3 or later core with MPU!
+#endif
+
+#if     OS_MPU_GUARD < 32 || (OS_MPU_GUARD & (OS_MPU_GUARD - 1))
+#error  osconfig.h: Incorrect OS_MPU_GUARD value! Must be a power of 2 not less then 32.
+#endif
+
+#define MPU_GUARD_REGION    7U
+
+#define MPU_GUARD_RASR    ( MPU_RASR_XN_Msk | (6U << MPU_RASR_AP_Pos) | (1U << MPU_RASR_TEX_Pos) | MPU_RASR_C_Msk | MPU_RASR_B_Msk | \
+                          ((30U - __CLZ(OS_MPU_GUARD)) << MPU_RASR_SIZE_Pos) | MPU_RASR_ENABLE_Msk )
+
+__STATIC_INLINE
+void port_mpu_guard( void *stack, size_t size )
+{
+	uint32_t base = ((uint32_t)(size_t)stack + (OS_MPU_GUARD) - 1) & ~((uint32_t)(OS_MPU_GUARD) - 1);
+
+	MPU->RBAR = base | MPU_RBAR_VALID_Msk | MPU_GUARD_REGION;
+	MPU->RASR = base + 2 * (OS_MPU_GUARD) <= (uint32_t)((size_t)stack + size) ? MPU_GUARD_RASR : 0;
+	__DSB();
+}
+
+#endif//OS_MPU_GUARD
+
 /* -------------------------------------------------------------------------- */
 
 #if __CORTEX_M > 0
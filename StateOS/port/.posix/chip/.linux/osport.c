@@ -0,0 +1,456 @@
+/******************************************************************************
+
+    @file    StateOS: osport.c
+    @author  Rajmund Szymanski
+    @date    05.09.2018
+    @brief   StateOS port file for Linux hosts.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "oskernel.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define TCK_NSEC(tck) ((uint64_t)(tck) / (OS_FREQUENCY) * 1000000000U + (uint64_t)(tck) % (OS_FREQUENCY) * 1000000000U / (OS_FREQUENCY))
+
+cpu_t Core = { 0, 0, 0 };
+
+static timer_t Tick;         // system timer
+#if HW_TIMER_SIZE && OS_ROBIN
+static timer_t Robin;        // timer for context switch triggering
+#endif
+#if HW_TIMER_SIZE
+static uint64_t Base  = 0;   // monotonic clock at the start of the system (in nanoseconds)
+static uint64_t Skip  = 0;   // virtual time skipped in idle periods (in ticks)
+#if OS_VIRTUAL_TIME
+static uint64_t Alarm = 0;   // time breakpoint (in ticks), 0 if cleared
+#endif
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+void PendSV_Handler( void );
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_sig_handler( int sig, siginfo_t *info, void *ctx )
+{
+	int err = errno;
+	(void) sig;
+	(void) ctx;
+	port_isr_pend((unsigned) info->si_value.sival_int);
+	errno = err;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tmr_create( timer_t *tmr, unsigned irq )
+{
+	struct sigevent sev = { 0 };
+
+	sev.sigev_notify = SIGEV_SIGNAL;
+	sev.sigev_signo  = SIGALRM;
+	sev.sigev_value.sival_int = (int) irq;
+
+	if (timer_create(CLOCK_MONOTONIC, &sev, tmr) != 0)
+		abort();
+}
+
+/* -------------------------------------------------------------------------- */
+// set timer 'tmr' to expire after 'delay' and then periodically with 'period' (in nanoseconds)
+// delay == 0 stops the timer
+
+static
+void priv_tmr_set( timer_t tmr, uint64_t delay, uint64_t period )
+{
+	struct itimerspec its;
+
+	its.it_value.tv_sec     = (time_t)(delay  / 1000000000U);
+	its.it_value.tv_nsec    = (long)  (delay  % 1000000000U);
+	its.it_interval.tv_sec  = (time_t)(period / 1000000000U);
+	its.it_interval.tv_nsec = (long)  (period % 1000000000U);
+
+	timer_settime(tmr, 0, &its, NULL);
+}
+
+/* -------------------------------------------------------------------------- */
+// return the time elapsed since the start of the system (in nanoseconds)
+
+#if HW_TIMER_SIZE
+
+static
+uint64_t priv_clk_get( void )
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec - Base;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// wait for any signal with the kernel lock set
+// the signal handler only marks the interrupt as pending
+
+#if HW_TIMER_SIZE == 0 && OS_TICKLESS_IDLE
+
+static
+void priv_sig_wait( void )
+{
+	sigset_t set, old;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &set, &old);
+	if (Core.pend == 0U)
+		sigsuspend(&old);
+	sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+void port_sys_init( void )
+{
+	struct sigaction sa;
+	static bool init = false;
+
+/******************************************************************************
+ Make sure that the system timer has not yet been initialized
+ This is only needed for compilers supporting the "constructor" function attribute or its equivalent
+*******************************************************************************/
+
+	if (init) return;
+	init = true;
+
+/******************************************************************************
+ End of check
+*******************************************************************************/
+
+/******************************************************************************
+ Configuration of signal of the system timers (interrupt)
+ Signal handler can be interrupted by another signal, so the signal is never blocked
+*******************************************************************************/
+
+	sa.sa_sigaction = priv_sig_handler;
+	sa.sa_flags     = SA_SIGINFO | SA_RESTART | SA_NODEFER;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGALRM, &sa, NULL);
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+#if HW_TIMER_SIZE == 0
+
+/******************************************************************************
+ Non-tick-less mode: configuration of system timer
+ It must generate interrupts with frequency OS_FREQUENCY
+*******************************************************************************/
+
+	priv_tmr_create(&Tick, IRQ_TICK);
+	priv_tmr_set(Tick, TCK_NSEC(1), TCK_NSEC(1));
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+#else //HW_TIMER_SIZE
+
+/******************************************************************************
+ Tick-less mode: configuration of system timer
+ The monotonic clock of the host is the counter, the timer is started by port_tmr_start
+*******************************************************************************/
+
+	Base = priv_clk_get();
+	priv_tmr_create(&Tick, IRQ_TICK);
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+	#if OS_ROBIN
+
+/******************************************************************************
+ Tick-less mode with preemption: configuration of timer for context switch triggering
+ It must generate interrupts with frequency OS_ROBIN
+*******************************************************************************/
+
+	priv_tmr_create(&Robin, IRQ_ROBIN);
+	priv_tmr_set(Robin, 1000000000U / (OS_ROBIN), 1000000000U / (OS_ROBIN));
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+	#endif//OS_ROBIN
+
+#endif//HW_TIMER_SIZE
+}
+
+/* -------------------------------------------------------------------------- */
+
+/******************************************************************************
+ Emulation of interrupt controller: execution of pending interrupts
+ Handler mode is entered atomically, so the handlers are never nested
+ The handler of context switch can leave this procedure on the stack of the preempted task
+*******************************************************************************/
+
+void port_isr_handler( void )
+{
+	unsigned irq;
+
+	while (!__atomic_exchange_n(&Core.isr, 1U, __ATOMIC_SEQ_CST))
+	{
+		while ((irq = Core.pend) != 0U)
+		{
+			if (irq & IRQ_TICK)
+			{
+				__atomic_fetch_and(&Core.pend, ~IRQ_TICK, __ATOMIC_SEQ_CST);
+#if HW_TIMER_SIZE == 0
+				core_sys_tick();
+#else
+				core_tmr_handler();
+#endif
+			}
+			else
+			if (irq & IRQ_ROBIN)
+			{
+				__atomic_fetch_and(&Core.pend, ~IRQ_ROBIN, __ATOMIC_SEQ_CST);
+				core_ctx_switch();
+			}
+			else
+			{
+				__atomic_fetch_and(&Core.pend, ~IRQ_SWITCH, __ATOMIC_SEQ_CST);
+				PendSV_Handler();
+			}
+		}
+
+		__atomic_store_n(&Core.isr, 0U, __ATOMIC_SEQ_CST);
+
+		if (Core.lock || !Core.pend)
+			break; // interrupt received after leaving the handler mode has already been executed
+	}
+}
+
+/******************************************************************************
+ End of the procedure
+*******************************************************************************/
+
+/******************************************************************************
+ Wait for interrupt: the idle task
+ In virtual time mode the system timer counter is advanced to the time breakpoint
+*******************************************************************************/
+
+void port_cpu_idle( void )
+{
+#if OS_VIRTUAL_TIME && HW_TIMER_SIZE
+	uint64_t now;
+
+	port_set_lock();
+	if (Alarm)
+	{
+		now = port_sys_time();
+		if (Alarm > now)
+			Skip += Alarm - now;
+		Alarm = 0;
+		port_isr_pend(IRQ_TICK);
+		port_clr_lock();
+		return;
+	}
+	port_clr_lock();
+#endif
+	pause();
+}
+
+/******************************************************************************
+ End of the procedure
+*******************************************************************************/
+
+#if HW_TIMER_SIZE == 0
+
+	#if OS_TICKLESS_IDLE
+
+/******************************************************************************
+ Non-tick-less mode with tick suppression: put the core to sleep
+ In virtual time mode the sleep is skipped and the last tick is pending at once
+*******************************************************************************/
+
+	#define TCK_MAX  0xFFFFFFFFU /* maximal number of suppressed ticks */
+
+cnt_t port_tck_sleep( cnt_t ticks )
+{
+#if OS_VIRTUAL_TIME
+
+	if (ticks == INFINITE)
+	{
+		priv_sig_wait();
+		return 0;
+	}
+
+	port_isr_pend(IRQ_TICK);
+
+	return ticks ? ticks - 1 : 0;
+
+#else
+
+	struct timespec beg, end;
+	sigset_t set, old;
+	uint64_t nsec;
+	cnt_t    tck = 0;
+
+	if (ticks > TCK_MAX)
+		ticks = TCK_MAX;
+
+	if (ticks <= 1)
+	{
+		priv_sig_wait();
+		return 0;
+	}
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &set, &old);
+
+	if ((Core.pend & IRQ_TICK) == 0U)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &beg);
+		priv_tmr_set(Tick, TCK_NSEC(ticks), TCK_NSEC(1));
+		sigsuspend(&old);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		if (Core.pend & IRQ_TICK)
+		{
+			// the last tick will be counted by the pending tick interrupt
+			tck  = ticks - 1;
+		}
+		else
+		{
+			// woken up by another signal
+			nsec = (uint64_t)(end.tv_sec - beg.tv_sec) * 1000000000U + (uint64_t)end.tv_nsec - (uint64_t)beg.tv_nsec;
+			tck  = (cnt_t)(nsec / TCK_NSEC(1));
+			priv_tmr_set(Tick, TCK_NSEC(tck + 1) - nsec, TCK_NSEC(1));
+		}
+	}
+
+	sigprocmask(SIG_SETMASK, &old, NULL);
+
+	return tck;
+
+#endif
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
+
+	#endif//OS_TICKLESS_IDLE
+
+#else //HW_TIMER_SIZE
+
+/******************************************************************************
+ Tick-less mode: return current system time
+*******************************************************************************/
+
+uint64_t port_sys_time( void )
+{
+	uint64_t nsec = priv_clk_get();
+
+	return nsec / 1000000000U * (OS_FREQUENCY) + nsec % 1000000000U * (OS_FREQUENCY) / 1000000000U + Skip;
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
+
+/******************************************************************************
+ Tick-less mode: clear time breakpoint
+*******************************************************************************/
+
+void port_tmr_stop( void )
+{
+#if OS_VIRTUAL_TIME
+	Alarm = 0;
+#endif
+	priv_tmr_set(Tick, 0, 0);
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
+
+/******************************************************************************
+ Tick-less mode: set time breakpoint
+ The timer expires when the counter reaches 'timeout', as the compare register of a hardware timer
+*******************************************************************************/
+
+void port_tmr_start( uint64_t timeout )
+{
+	uint64_t nsec = priv_clk_get();
+	uint64_t now  = nsec / 1000000000U * (OS_FREQUENCY) + nsec % 1000000000U * (OS_FREQUENCY) / 1000000000U + Skip;
+	uint64_t tck;
+
+	tck  = now + (cnt_t)((cnt_t)timeout - (cnt_t)now);
+#if OS_VIRTUAL_TIME
+	Alarm = tck;
+#endif
+	tck  = TCK_NSEC(tck - Skip);
+
+	priv_tmr_set(Tick, tck > nsec ? tck - nsec : 1, 0);
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
+
+	#if OS_ROBIN
+
+/******************************************************************************
+ Tick-less mode with preemption: reset context switch indicator
+*******************************************************************************/
+
+void port_ctx_reset( uint32_t slice )
+{
+	priv_tmr_set(Robin, TCK_NSEC(slice), TCK_NSEC(slice));
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
+
+	#endif//OS_ROBIN
+
+#endif//HW_TIMER_SIZE
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,225 @@
+/******************************************************************************
+
+    @file    StateOS: osport.h
+    @author  Rajmund Szymanski
+    @date    05.09.2018
+    @brief   StateOS port definitions for Linux hosts.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOSPORT_H
+#define __STATEOSPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#ifndef   NOCONFIG
+#include "osconfig.h"
+#endif
+#include "osdefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_FREQUENCY
+#define OS_FREQUENCY       1000 /* Hz */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// !! WARNING! OS_TIMER_SIZE < HW_TIMER_SIZE may cause unexpected problems !!
+
+#ifndef OS_TIMER_SIZE
+#define OS_TIMER_SIZE        32 /* bit size of system timer counter           */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// !! WARNING! OS_TIMER_SIZE < HW_TIMER_SIZE may cause unexpected problems !!
+// in tick-less mode the system timer counter is the monotonic clock of the host
+
+#ifdef  HW_TIMER_SIZE
+#error  HW_TIMER_SIZE is an internal os definition!
+#elif   OS_FREQUENCY > 1000
+#define HW_TIMER_SIZE (OS_TIMER_SIZE) /* bit size of hardware timer           */
+#else
+#define HW_TIMER_SIZE         0 /* os does not work in tick-less mode         */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_ROBIN
+#define OS_ROBIN              0 /* system works in cooperative mode           */
+#endif
+
+#if     OS_ROBIN > OS_FREQUENCY
+#error  osconfig.h: Incorrect OS_ROBIN value!
+#endif
+
+/* -------------------------------------------------------------------------- */
+// virtual time: idle periods are skipped
+// as soon as the system becomes idle, the system timer counter is advanced to the nearest event of the timers queue
+// in non-tick-less mode the idle periods are skipped by port_tck_sleep, so OS_TICKLESS_IDLE is required
+
+#ifndef OS_VIRTUAL_TIME
+#define OS_VIRTUAL_TIME       0 /* system timer follows the real time         */
+#endif
+
+#if     OS_VIRTUAL_TIME && HW_TIMER_SIZE == 0
+#ifndef OS_TICKLESS_IDLE
+#define OS_TICKLESS_IDLE      1 /* idle periods are skipped by port_tck_sleep */
+#elif  !OS_TICKLESS_IDLE
+#error  osconfig.h: OS_VIRTUAL_TIME requires OS_TICKLESS_IDLE in non-tick-less mode!
+#endif
+#endif
+
+/* -------------------------------------------------------------------------- */
+// emulated interrupts
+// all tasks share the main thread of the host process, signals of the host serve as interrupts
+// the kernel lock doesn't block signals (it would cost a system call), it is only a flag
+// interrupt received with the kernel lock set or during another interrupt handler is only marked as pending
+// pending interrupts are executed as soon as the kernel lock is cleared, context switch (PendSV) goes last
+
+#define IRQ_TICK            1U  // system timer
+#define IRQ_ROBIN           2U  // round-robin timer (tick-less mode with preemption)
+#define IRQ_SWITCH          4U  // context switch
+
+typedef struct __cpu cpu_t;
+
+struct __cpu
+{
+	volatile unsigned lock; // kernel lock is set (interrupts are masked)
+	volatile unsigned isr;  // interrupt handler is being executed (handler mode)
+	volatile unsigned pend; // pending interrupts (IRQ_xxx)
+};
+
+extern cpu_t Core;
+
+// execute all pending interrupts, unless the kernel lock is set or in handler mode
+void port_isr_handler( void );
+
+// mark interrupt 'irq' as pending and execute it, unless the kernel lock is set or in handler mode
+__STATIC_INLINE
+void port_isr_pend( unsigned irq )
+{
+	__atomic_fetch_or(&Core.pend, irq, __ATOMIC_SEQ_CST);
+	if (!Core.lock)
+		port_isr_handler();
+}
+
+// wait for interrupt (procedure of the idle task)
+void port_cpu_idle( void );
+
+#define __WFI               port_cpu_idle
+
+/* -------------------------------------------------------------------------- */
+// return current system time
+
+#if HW_TIMER_SIZE
+
+uint64_t port_sys_time( void );
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// force yield system control to the next process
+
+__STATIC_INLINE
+void port_ctx_switch( void )
+{
+	port_isr_pend(IRQ_SWITCH);
+}
+
+/* -------------------------------------------------------------------------- */
+// reset context switch indicator
+// 'slice' is the time slice of the next task (in ticks)
+
+#if HW_TIMER_SIZE && OS_ROBIN
+
+void port_ctx_reset( uint32_t slice );
+
+#else
+
+__STATIC_INLINE
+void port_ctx_reset( uint32_t slice )
+{
+	(void) slice;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// clear time breakpoint
+
+#if HW_TIMER_SIZE
+
+void port_tmr_stop( void );
+
+#else
+
+__STATIC_INLINE
+void port_tmr_stop( void )
+{
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// set time breakpoint
+
+#if HW_TIMER_SIZE
+
+void port_tmr_start( uint64_t timeout );
+
+#else
+
+__STATIC_INLINE
+void port_tmr_start( uint64_t timeout )
+{
+	(void) timeout;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// force timer interrupt
+
+__STATIC_INLINE
+void port_tmr_force( void )
+{
+#if HW_TIMER_SIZE
+	port_isr_pend(IRQ_TICK);
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOSPORT_H
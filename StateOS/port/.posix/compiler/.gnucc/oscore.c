@@ -0,0 +1,98 @@
+/******************************************************************************
+
+    @file    StateOS: oscore.c
+    @author  Rajmund Szymanski
+    @date    05.09.2018
+    @brief   StateOS port file for POSIX hosts.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#if defined(__GNUC__)
+
+#include <signal.h>
+#include <stdlib.h>
+#include "oskernel.h"
+#include "inc/ostask.h"
+
+/* -------------------------------------------------------------------------- */
+// prepare the new context 'ctx' placed at the top of stack area 'stack'
+// the rest of the stack area below the context is the stack of the task
+
+static
+void priv_ctx_make( ctx_t *ctx, void *stack )
+{
+	getcontext(&ctx->uc);
+	sigdelset(&ctx->uc.uc_sigmask, SIGALRM);
+	ctx->uc.uc_stack.ss_sp   = stack;
+	ctx->uc.uc_stack.ss_size = (size_t)ctx - (size_t)stack;
+	ctx->uc.uc_link          = NULL;
+	makecontext(&ctx->uc, ctx->pc, 0);
+	ctx->pc = NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+// context switch handler
+// the context of the current task is saved on its own stack, in the frame of this handler
+// the preempted task will be resumed inside this handler, still in handler mode
+// the new task starts in thread mode with the kernel lock set (core_tsk_loop clears it)
+
+void PendSV_Handler( void )
+{
+	ctx_t  ctx;
+	ctx_t *nxt;
+
+	ctx.pc = NULL;
+	nxt = core_tsk_handler(&ctx);
+
+	if (nxt == &ctx)
+		return;
+
+	if (nxt->pc)
+	{
+		priv_ctx_make(nxt, System.cur->stack);
+		port_set_lock();
+		Core.isr = 0U;
+	}
+
+	swapcontext(&ctx.uc, &nxt->uc);
+}
+
+/* -------------------------------------------------------------------------- */
+// the main task has no stack area, the default stack below 'sp' is used
+
+void core_tsk_flip( void *sp )
+{
+	ctx_t *ctx = (ctx_t *)sp - 1;
+	void  *stk = System.cur->size ? System.cur->stack : (void *)((stk_t *)sp - STK_SIZE(OS_STACK_SIZE));
+
+	ctx->pc = core_tsk_loop;
+	priv_ctx_make(ctx, stk);
+	setcontext(&ctx->uc);
+	abort();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __GNUC__
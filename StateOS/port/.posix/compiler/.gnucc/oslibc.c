@@ -0,0 +1,227 @@
+/******************************************************************************
+
+    @file    StateOS: oslibc.c
+    @author  Rajmund Szymanski
+    @date    05.09.2018
+    @brief   StateOS port file for POSIX hosts.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#if defined(__GNUC__)
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "oskernel.h"
+
+#if defined(__GLIBC__)
+
+/* -------------------------------------------------------------------------- */
+// memory allocator of the host C library is protected with the kernel lock
+// tasks preempted by the signal handlers share the same thread of the host process,
+// so the locks of the host C library don't protect them from each other
+
+void *__libc_malloc ( size_t size );
+void *__libc_calloc ( size_t num, size_t size );
+void *__libc_realloc( void *ptr, size_t size );
+void  __libc_free   ( void *ptr );
+
+/* -------------------------------------------------------------------------- */
+
+void *malloc( size_t size )
+{
+	void *ptr;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	ptr = __libc_malloc(size);
+	port_put_lock(lck);
+	return ptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void *calloc( size_t num, size_t size )
+{
+	void *ptr;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	ptr = __libc_calloc(num, size);
+	port_put_lock(lck);
+	return ptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void *realloc( void *ptr, size_t size )
+{
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	ptr = __libc_realloc(ptr, size);
+	port_put_lock(lck);
+	return ptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void free( void *ptr )
+{
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	__libc_free(ptr);
+	port_put_lock(lck);
+}
+
+/* -------------------------------------------------------------------------- */
+// standard output of the host C library is protected with the kernel lock in the same way
+// the functions are wrapped by the linker (see WRAP in makefile.posix);
+// the compiler may turn printf into puts, putchar or fwrite, so these are wrapped as well
+// the original functions are weak references, so the port can be linked also without the wrappers
+
+int    __real_vfprintf( FILE *stream, const char *format, va_list arg )                 __attribute__((weak));
+int    __real_puts    ( const char *str )                                                __attribute__((weak));
+int    __real_putchar ( int chr )                                                        __attribute__((weak));
+int    __real_fputs   ( const char *str, FILE *stream )                                  __attribute__((weak));
+int    __real_fputc   ( int chr, FILE *stream )                                          __attribute__((weak));
+size_t __real_fwrite  ( const void *ptr, size_t size, size_t num, FILE *stream )         __attribute__((weak));
+int    __real_fflush  ( FILE *stream )                                                   __attribute__((weak));
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_vfprintf( FILE *stream, const char *format, va_list arg )
+{
+	int result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = __real_vfprintf(stream, format, arg);
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_vprintf( const char *format, va_list arg )
+{
+	return __wrap_vfprintf(stdout, format, arg);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_fprintf( FILE *stream, const char *format, ... )
+{
+	int result;
+	va_list arg;
+	va_start(arg, format);
+	result = __wrap_vfprintf(stream, format, arg);
+	va_end(arg);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_printf( const char *format, ... )
+{
+	int result;
+	va_list arg;
+	va_start(arg, format);
+	result = __wrap_vfprintf(stdout, format, arg);
+	va_end(arg);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_puts( const char *str )
+{
+	int result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = __real_puts(str);
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_putchar( int chr )
+{
+	int result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = __real_putchar(chr);
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_fputs( const char *str, FILE *stream )
+{
+	int result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = __real_fputs(str, stream);
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_fputc( int chr, FILE *stream )
+{
+	int result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = __real_fputc(chr, stream);
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+size_t __wrap_fwrite( const void *ptr, size_t size, size_t num, FILE *stream )
+{
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	num = __real_fwrite(ptr, size, num, stream);
+	port_put_lock(lck);
+	return num;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int __wrap_fflush( FILE *stream )
+{
+	int result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = __real_fflush(stream);
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __GLIBC__
+
+#endif // __GNUC__
@@ -0,0 +1,241 @@
+/******************************************************************************
+
+    @file    StateOS: oscore.h
+    @author  Rajmund Szymanski
+    @date    05.09.2018
+    @brief   StateOS port file for POSIX hosts.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOSCORE_H
+#define __STATEOSCORE_H
+
+#include <time.h>
+#include <ucontext.h>
+#include "osbase.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_HEAP_SIZE
+#define OS_HEAP_SIZE          0 /* default system heap: all free memory       */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// signal handlers and the host C library are executed on the stacks of tasks
+// so the stack sizes of the firmware examples (e.g. 256 bytes) are too small on the host
+// smaller stacks of tasks defined with the kernel macros or created with wrk_create are enlarged to OS_STACK_MIN
+
+#ifndef OS_STACK_SIZE
+#define OS_STACK_SIZE     65536 /* default task stack size in bytes           */
+#endif
+
+#ifndef OS_STACK_MIN
+#define OS_STACK_MIN      16384 /* minimal task stack size in bytes           */
+#endif
+
+#ifndef OS_IDLE_STACK
+#define OS_IDLE_STACK     32768 /* idle task stack size in bytes              */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_LOCK_LEVEL
+#define OS_LOCK_LEVEL         0 /* critical section blocks all interrupts     */
+#endif
+
+#if     OS_LOCK_LEVEL > 0
+#error  osconfig.h: Incorrect OS_LOCK_LEVEL value! Must be 0.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MAIN_PRIO
+#define OS_MAIN_PRIO          0 /* priority of main process                   */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if     OS_MPU_GUARD
+#error  osconfig.h: OS_MPU_GUARD is not available for the posix port!
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef  __cplusplus
+
+#ifndef OS_FUNCTIONAL
+#define OS_FUNCTIONAL         1 /* include c++ functional library header      */
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+typedef unsigned              lck_t;
+#ifdef  __SIZEOF_INT128__
+__extension__
+typedef unsigned __int128     stk_t;
+#else
+typedef uint64_t              stk_t;
+#endif
+
+/* -------------------------------------------------------------------------- */
+// task context
+// the context of the preempted task is saved on its own stack by the context switch handler (PendSV_Handler)
+// the context of the new task is placed at the top of its stack and the task is started at 'pc'
+
+typedef struct __ctx ctx_t;
+
+struct __ctx
+{
+	fun_t    * pc;  // entry point of the new task, NULL for the saved context
+	ucontext_t uc;  // context saved by the software
+};
+
+#define _CTX_INIT( fun ) { .pc = fun }
+
+/* -------------------------------------------------------------------------- */
+// init task context
+
+__STATIC_INLINE
+void port_ctx_init( ctx_t *ctx, fun_t *pc )
+{
+	ctx->pc = pc;
+}
+
+/* -------------------------------------------------------------------------- */
+// is procedure inside ISR?
+
+__STATIC_INLINE
+bool port_isr_context( void )
+{
+	return (Core.isr != 0U);
+}
+
+/* -------------------------------------------------------------------------- */
+// are interrupts masked?
+
+__STATIC_INLINE
+bool port_isr_masked( void )
+{
+	return (Core.lock != 0U);
+}
+
+/* -------------------------------------------------------------------------- */
+// get current stack pointer
+
+__STATIC_INLINE
+void * port_get_sp( void )
+{
+	return __builtin_frame_address(0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#define port_set_barrier()  __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+__STATIC_INLINE
+void port_set_lock( void )
+{
+	Core.lock = 1U;
+	port_set_barrier();
+}
+
+__STATIC_INLINE
+void port_clr_lock( void )
+{
+	port_set_barrier();
+	Core.lock = 0U;
+	port_set_barrier();
+	if (Core.pend)
+		port_isr_handler();
+}
+
+__STATIC_INLINE
+lck_t port_get_lock( void )
+{
+	return Core.lock;
+}
+
+__STATIC_INLINE
+void port_put_lock( lck_t lck )
+{
+	if (lck)
+		port_set_lock();
+	else
+		port_clr_lock();
+}
+
+/* -------------------------------------------------------------------------- */
+// clear pending context switch request
+
+__STATIC_INLINE
+void port_ctx_clear( void )
+{
+	__atomic_fetch_and(&Core.pend, ~IRQ_SWITCH, __ATOMIC_SEQ_CST);
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically increment the counter '*cnt' unless it is equal to 'lim'
+// return the previous value of the counter
+
+__STATIC_INLINE
+unsigned port_cnt_inc( volatile unsigned *cnt, unsigned lim )
+{
+	unsigned val = *cnt;
+	while (val != lim && !__atomic_compare_exchange_n(cnt, &val, val + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+	return val;
+}
+
+/* -------------------------------------------------------------------------- */
+// return time stamp for CPU time accounting, lock windows profiling and event trace
+// monotonic clock of the host in microseconds (it doesn't include the skipped virtual time)
+// CPU_TIME_FREQUENCY is the frequency of the time stamp counter
+
+#if OS_CPU_STATS || OS_LOCK_STATS || OS_TRACE
+
+#define CPU_TIME_FREQUENCY  1000000
+
+__STATIC_INLINE
+uint32_t port_cpu_time( void )
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)ts.tv_sec * 1000000U + (uint32_t)ts.tv_nsec / 1000U;
+}
+
+#endif//OS_CPU_STATS || OS_LOCK_STATS || OS_TRACE
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//__STATEOSCORE_H
@@ -82,6 +82,32 @@ extern "C" {
 #error  osconfig.h: Incorrect OS_ROBIN value!
 #endif
 
+/* -------------------------------------------------------------------------- */
+
+#if     defined(OS_TICKLESS_IDLE) && OS_TICKLESS_IDLE
+#error  osconfig.h: OS_TICKLESS_IDLE is not supported by this port!
+#endif
+
+#if     defined(OS_ISR_QUEUE) && OS_ISR_QUEUE
+#error  osconfig.h: OS_ISR_QUEUE is not supported by this port!
+#endif
+
+#if     defined(OS_CPU_STATS) && OS_CPU_STATS
+#error  osconfig.h: OS_CPU_STATS is not supported by this port!
+#endif
+
+#if     defined(OS_LOCK_STATS) && OS_LOCK_STATS
+#error  osconfig.h: OS_LOCK_STATS is not supported by this port!
+#endif
+
+#if     defined(OS_TRACE) && OS_TRACE
+#error  osconfig.h: OS_TRACE is not supported by this port!
+#endif
+
+#if     defined(OS_MPU_GUARD) && OS_MPU_GUARD
+#error  osconfig.h: OS_MPU_GUARD is not supported by this port!
+#endif
+
 /* -------------------------------------------------------------------------- */
 // return current system time
 
@@ -106,19 +132,23 @@ void port_ctx_switch( void )
 
 /* -------------------------------------------------------------------------- */
 // reset context switch indicator
+// 'slice' is the time slice of the next task (in ticks)
 
 __STATIC_INLINE
-void port_ctx_reset( void )
+void port_ctx_reset( uint32_t slice )
 {
 #if HW_TIMER_SIZE
 	#if OS_ROBIN
-	uint16_t timeout = (((uint16_t)TIM3->CNTRH << 8) | TIM3->CNTRL) + (CPU_FREQUENCY)/(OS_FREQUENCY);
+	uint16_t timeout = (((uint16_t)TIM3->CNTRH << 8) | TIM3->CNTRL) + (slice < UINT16_MAX ? (uint16_t)slice : UINT16_MAX);
 	TIM3->CCR1H = (uint8_t)(timeout >> 8);
 	TIM3->CCR1L = (uint8_t)(timeout);
 	#else
+	(void) slice;
 	TIM3->CCR1H = TIM3->CNTRH;
 	TIM3->CCR1L = TIM3->CNTRL;
 	#endif
+#else
+	(void) slice;
 #endif
 }
 
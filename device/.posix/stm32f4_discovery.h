@@ -0,0 +1,171 @@
+/******************************************************************************
+ * @file    stm32f4_discovery.h
+ * @author  Rajmund Szymanski
+ * @date    05.09.2018
+ * @brief   This file contains emulation of STM32F4-Discovery Kit for the posix port.
+ ******************************************************************************/
+
+#ifndef __STM32F4_DISCOVERY_H
+#define __STM32F4_DISCOVERY_H
+
+#include <stdio.h>
+#include <os.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+// leds are emulated with variables, so the examples can be run on the host
+// the state of the leds is printed with the system time whenever it changes:
+// LED_Tick and the methods of the c++ classes print it at once,
+// direct writes to the variables (LEDs, LED[], LEDG, ...) are found by a timer polling the leds every millisecond
+
+static volatile unsigned GRN;    // usb green led
+static volatile unsigned LED[4]; // leds array
+static volatile unsigned LEDs;   // leds as a 4-bit value
+
+#define LEDG LED[0]              // green led
+#define LEDO LED[1]              // orange led
+#define LEDR LED[2]              // red led
+#define LEDB LED[3]              // blue led
+
+static unsigned LED_Copy[4];     // leds array at the last print
+static unsigned LEDs_Copy;       // leds at the last print
+static unsigned GRN_Copy;        // usb green led at the last print
+
+/* -------------------------------------------------------------------------- */
+// print the state of the leds
+// the leds array and the 4-bit value are two views of the same leds (bit-banding on the target), so they are merged first
+
+static inline
+void LED_Print( void )
+{
+	unsigned i;
+
+	for (i = 0; i < 4; i++)
+		if (LED[i] != LED_Copy[i])
+			LEDs = (LEDs & ~(1U << i)) | ((LED[i] & 1U) << i);
+	for (i = 0; i < 4; i++)
+		LED[i] = LED_Copy[i] = (LEDs >> i) & 1U;
+	LEDs_Copy = LEDs;
+	GRN_Copy  = GRN;
+
+	printf("%10lu: leds %c%c%c%c grn %c\n", (unsigned long) sys_time(),
+	       LEDs & 1 ? 'G' : '-', LEDs & 2 ? 'O' : '-', LEDs & 4 ? 'R' : '-', LEDs & 8 ? 'B' : '-', GRN & 1 ? 'G' : '-');
+	fflush(stdout);
+}
+
+/* -------------------------------------------------------------------------- */
+// print the state of the leds if it has been changed by a direct write (timer procedure)
+
+static inline
+void LED_Poll( void )
+{
+	unsigned i;
+
+	if (LEDs != LEDs_Copy || GRN != GRN_Copy)
+	{
+		LED_Print();
+		return;
+	}
+
+	for (i = 0; i < 4; i++)
+	{
+		if (LED[i] != LED_Copy[i])
+		{
+			LED_Print();
+			return;
+		}
+	}
+}
+
+static_TMR(LED_Timer, LED_Poll);
+
+/* -------------------------------------------------------------------------- */
+// start polling the leds
+
+static inline
+void LED_Watch( void )
+{
+	port_sys_init(); // may be called from a constructor of a c++ class
+	tmr_startPeriodic(LED_Timer, MSEC ? MSEC : 1);
+}
+
+/* -------------------------------------------------------------------------- */
+// init usb green led
+
+static inline
+void GRN_Init( void )
+{
+	GRN = GRN_Copy = 0;
+	LED_Watch();
+}
+
+/* -------------------------------------------------------------------------- */
+// init leds
+
+static inline
+void LED_Init( void )
+{
+	unsigned i;
+
+	for (i = 0; i < 4; i++)
+		LED[i] = LED_Copy[i] = 0;
+	LEDs = LEDs_Copy = 0;
+	LED_Watch();
+}
+
+/* -------------------------------------------------------------------------- */
+// rotate leds
+
+static inline
+void LED_Tick( void )
+{
+	LEDs = (LEDs << 1) & 0xE ? (LEDs << 1) & 0xE : 1;
+	LED_Print();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef  __cplusplus
+}
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef  __cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+class GreenLed
+{
+public:
+	GreenLed( void ) { GRN_Init(); }
+	operator   unsigned & ( void )                  { return (unsigned &)GRN; }
+	unsigned   operator = ( const unsigned status ) { GRN = status & 1; LED_Print(); return GRN; }
+	unsigned   operator ! ( void ) /* ++grn */      { return GRN ^ 1U; }
+	unsigned   operator ++( void ) /* ++grn */      { GRN = (GRN + 1) & 1; LED_Print(); return GRN; }
+	unsigned   operator ++( int  ) /* grn++ */      { unsigned status = GRN; GRN = (status + 1) & 1; LED_Print(); return status; }
+};
+
+/* -------------------------------------------------------------------------- */
+
+class Led
+{
+	unsigned get( void )            { return LEDs; }
+	void     set( unsigned status ) { LEDs = status & 0xF; LED_Print(); }
+public:
+	Led( void ) { LED_Init(); }
+	unsigned & operator []( const unsigned number ) { return (unsigned &)LED[number]; }
+	unsigned   operator = ( const unsigned status ) {                              set(status); return status & 0xF; }
+	unsigned   operator ++( void ) /* ++led */      { unsigned status = get() + 1; set(status); return status & 0xF; }
+	unsigned   operator ++( int  ) /* led++ */      { unsigned status = get(); set(status + 1); return status; }
+	void tick( void ) { LED_Tick(); }
+};
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__cplusplus
+
+#endif//__STM32F4_DISCOVERY_H
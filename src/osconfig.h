@@ -45,6 +45,7 @@
 // system mode, round-robin frequency in Hz
 // OS_ROBIN == 0 => os works in cooperative mode
 // OS_ROBIN >  0 => os works in preemptive mode, OS_ROBIN indicates round-robin frequency
+//                  the default time slice of tasks; it can be changed for every task (tsk_setQuantum)
 // default value: 0
 #define OS_ROBIN           1000
 
@@ -67,6 +68,33 @@
 // default value: 0
 #define OS_HEAP_SIZE          0
 
+// ----------------------------
+// allocator of the system heap (OS_HEAP_SIZE > 0)
+// OS_HEAP_TLSF == 0 => the heap is a list of segments, first fit; free segments are merged when searched
+// OS_HEAP_TLSF == 1 => two-level segregated fit (TLSF): sys_alloc and sys_free in constant time,
+//                      free blocks are merged immediately; the memory of the allocated block is cleared outside the kernel lock
+// default value: 0
+#define OS_HEAP_TLSF          0
+
+// ----------------------------
+// slab caches of control blocks of objects created at runtime (xxx_create, CMSIS-RTOS osXxxNew)
+// OS_SLAB_SIZE == 0 => control blocks are allocated with sys_alloc and released with sys_free
+// OS_SLAB_SIZE >  0 => control blocks of fixed size (semaphores, mutexes, timers, flags, events, signals, barriers,
+//                      condition variables, lists) are allocated from the cache of their type in constant time;
+//                      the cache grows by OS_SLAB_SIZE control blocks allocated with sys_alloc, released blocks are
+//                      recycled and never returned to the heap
+// default value: 0
+#define OS_SLAB_SIZE          0
+
+// ----------------------------
+// statistics of the system heap (sys_heapStats, OSAL OS_HeapGetInfo)
+// OS_HEAP_STATS == 0 => statistics are not collected
+// OS_HEAP_STATS == 1 => sys_alloc and sys_free count allocations, failures and used memory (with the high-water mark);
+//                      the largest free block and the number of free blocks are reported by sys_heapStats
+//                      (TLSF: in constant time; first fit: the list of segments is walked under the kernel lock)
+// default value: 0
+#define OS_HEAP_STATS         0
+
 // ----------------------------
 // default task stack size in bytes
 // default value: 256
@@ -82,3 +110,94 @@
 // available values: 16, 32, 64
 // default value: 32
 #define OS_TIMER_SIZE        32
+
+// ----------------------------
+// number of priority levels of the tasks' READY queue
+// OS_PRIO_LEVELS == 0 => tasks' READY queue is a sorted list, task insertion time depends on the number of ready tasks
+// OS_PRIO_LEVELS >  0 => tasks' READY queue is divided into OS_PRIO_LEVELS fifo levels with a priority bitmap, all operations take constant time
+//                        task priorities greater or equal to (OS_PRIO_LEVELS-1) are mapped to the highest level
+// available values: 0..32
+// default value: 0
+#define OS_PRIO_LEVELS        0
+
+// ----------------------------
+// number of levels of the hierarchical timing wheel for the timers queue
+// OS_WHEEL_LEVELS == 0 => timers queue is a sorted list, timer insertion time depends on the number of running timers and delayed tasks
+// OS_WHEEL_LEVELS >  1 => timers queue is a hierarchical timing wheel with 32 slots per level, timer insertion and removal take constant time
+//                         each level covers 5 bits of the timer counter, longer delays are cascaded from the highest level
+// available values: 0, 2..(OS_TIMER_SIZE-1)/5
+// default value: 0
+#define OS_WHEEL_LEVELS       0
+
+// ----------------------------
+// earliest deadline first scheduling of tasks with the same priority
+// OS_EDF == 0 => tasks of the same priority are scheduled in fifo order
+// OS_EDF != 0 => tasks of the same priority with a relative deadline (tsk_setDeadline) are scheduled by their absolute deadlines
+//                and ahead of tasks without a deadline; the deadline is set when the task is started or resumed,
+//                a task resumed by a timeout (e.g. tsk_sleepNext) gets its deadline counted from the end of the countdown
+// default value: 0
+#define OS_EDF                0
+
+// ----------------------------
+// suppression of system timer ticks when the system is idle (only when HW_TIMER_SIZE == 0)
+// OS_TICKLESS_IDLE == 0 => system timer generates interrupts with frequency OS_FREQUENCY all the time
+// OS_TICKLESS_IDLE != 0 => before going to sleep, the idle task reprograms the system timer to the nearest event of the timers queue
+//                          and compensates the system timer counter for the suppressed ticks after wakeup
+// default value: 0
+#define OS_TICKLESS_IDLE      0
+
+// ----------------------------
+// size of the queue of procedures deferred by interrupt handlers (xxx_giveAsync functions)
+// OS_ISR_QUEUE == 0 => no queue of deferred procedures
+// OS_ISR_QUEUE >  0 => interrupt handlers post requests to the queue without the kernel lock,
+//                      requests are executed in the context switch handler; must be a power of 2
+// default value: 0
+#define OS_ISR_QUEUE          0
+
+// ----------------------------
+// CPU time accounting of tasks (tsk_getLoad, tsk_getTime, tsk_getSwitches functions)
+// OS_CPU_STATS == 0 => no accounting
+// OS_CPU_STATS == 1 => run time of every task is counted in the context switch handler,
+//                      in processor cycles (DWT cycle counter on Cortex-M3 and later) or in ticks of system timer otherwise
+// default value: 0
+#define OS_CPU_STATS          0
+
+// ----------------------------
+// stack usage tracking (tsk_getStackUsed, tsk_stackReport, sys_getStackUsed functions)
+// OS_STACK_STATS == 0 => stacks are filled only in DEBUG mode, no high-water marks
+// OS_STACK_STATS >  0 => stacks of tasks are painted with a pattern when tasks are started, high-water marks are available;
+//                        the value is the size (in bytes) of the guard band at the bottom of the stack, it is checked
+//                        for the preempted task at every context switch
+// default value: 0
+#define OS_STACK_STATS        0
+
+// ----------------------------
+// profiling of the kernel lock windows (sys_getLockTime, sys_lockReport functions)
+// OS_LOCK_STATS == 0 => no profiling
+// OS_LOCK_STATS == 1 => every window with the kernel lock set (interrupts masked) is measured and attributed to the call site,
+//                       which set the lock (sys_lock, critical section, kernel handlers); the longest window, the histogram
+//                       and the total time of windows are kept for every call site; new longest windows are written to the trace;
+//                       time is measured in processor cycles (DWT cycle counter on Cortex-M3 and later) or in ticks of system timer otherwise
+// default value: 0
+#define OS_LOCK_STATS         0
+
+// ----------------------------
+// MPU stack guard (Cortex-M3 and later with MPU)
+// OS_MPU_GUARD == 0 => stacks of tasks aren't guarded
+// OS_MPU_GUARD >  0 => the context switch handler sets MPU region 7 as a read-only guard at the bottom of the stack
+//                      of the next task, the value is the size of the guard (in bytes); must be a power of 2, at least 32;
+//                      stack overflow generates MemManage fault, the stack of the task must be at least twice as big as the guard,
+//                      up to (OS_MPU_GUARD-1) bytes below the guard aren't used (the guard is aligned to its size);
+//                      cost per context switch: about 10 instructions (two writes to MPU registers and a data barrier),
+//                      measured on the target with examples/_bench_kernel.c_ (lines "ctx_switch" with and without the guard, "mpu_guard")
+// default value: 0
+#define OS_MPU_GUARD          0
+
+// ----------------------------
+// size of the buffer of kernel event trace (number of records)
+// OS_TRACE == 0 => no trace
+// OS_TRACE >  0 => context switches, suspensions and resumptions of tasks, timer events and operations on all the objects
+//                  which can be given or taken (from semaphores to memory pools) are recorded with time stamps (as for OS_CPU_STATS) in the ring buffer 'Trace',
+//                  the oldest records are overwritten; dump the buffer and decode it with tools/.ostrace; must be a power of 2
+// default value: 0
+#define OS_TRACE              0
@@ -0,0 +1,462 @@
+/******************************************************************************
+
+    @file    StateOS: ostrace.c
+    @author  Rajmund Szymanski
+    @date    04.09.2018
+    @brief   Host decoder of the kernel event trace of StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************
+
+   Decodes the dump of the 'Trace' buffer (OS_TRACE > 0) into a timeline
+   in Chrome trace format (chrome://tracing, ui.perfetto.dev) or into text.
+
+   build:
+     cc -O2 -o ostrace ostrace.c
+
+   dump the buffer (e.g. QEMU with gdb server, or any debug probe):
+     qemu-system-arm -M netduinoplus2 -kernel app.elf -s -S &
+     arm-none-eabi-gdb app.elf -batch -ex "target remote :1234" -ex "continue" \
+       -ex "dump binary value trace.bin Trace"          (after interrupting the target)
+     arm-none-eabi-nm app.elf > app.sym
+
+   decode:
+     ostrace [-t] [-s app.sym] [-o trace.json] trace.bin
+
+   -s  names objects by the symbols of the application (output of nm),
+       otherwise objects are identified by their addresses
+   -t  prints the text timeline instead of json
+   -o  writes the output to the file instead of stdout
+
+   the size of object addresses in the records follows the target
+   (32-bit for microcontrollers, 64-bit for the posix port on 64-bit hosts)
+
+   time stamps are 32-bit, so consecutive records must be less than
+   2^32 counts of the time stamp counter apart
+   QEMU doesn't emulate the DWT cycle counter, so under QEMU the order
+   of records is exact, but their time stamps are zero
+
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../StateOS/kernel/ostrace.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define E_SUCCESS  0x0000U // low 16 bits of event values
+#define E_TIMEOUT  0xFFFFU
+#define E_STOPPED  0xFFFEU
+
+typedef struct { uint64_t addr; char *name; } sym_t;
+
+static sym_t   *Sym;
+static size_t   SymCount;
+
+static uint64_t *Tid;   // tracks of the timeline (tasks and timers)
+static char     *TidTmr;
+static size_t    TidCount;
+
+static int       Swap;  // the target has different endianness than the host
+static int       Text;
+static FILE     *Out;
+
+/* -------------------------------------------------------------------------- */
+
+static
+uint32_t get32( uint32_t val )
+{
+	if (Swap)
+		val = (val >> 24) | ((val >> 8) & 0xFF00U) | ((val << 8) & 0xFF0000U) | (val << 24);
+	return val;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+uint64_t get64( uint64_t val )
+{
+	if (Swap)
+		val = ((uint64_t)get32((uint32_t)val) << 32) | get32((uint32_t)(val >> 32));
+	return val;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+uint16_t get16( uint16_t val )
+{
+	if (Swap)
+		val = (uint16_t)((val >> 8) | (val << 8));
+	return val;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void *xalloc( void *ptr, size_t size )
+{
+	ptr = realloc(ptr, size);
+	if (ptr == NULL)
+	{
+		fprintf(stderr, "ostrace: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	return ptr;
+}
+
+/* -------------------------------------------------------------------------- */
+// read symbols in the format of nm output: "<address> <type> <name>"
+
+static
+void sym_load( const char *file )
+{
+	char     line[512], type, name[400];
+	unsigned long long addr;
+	FILE   * fp = fopen(file, "r");
+
+	if (fp == NULL)
+	{
+		perror(file);
+		exit(EXIT_FAILURE);
+	}
+
+	while (fgets(line, sizeof(line), fp))
+	{
+		if (sscanf(line, "%llx %c %399s", &addr, &type, name) != 3)
+			continue;
+		if (strchr("bBdDrRsS", type) == NULL)
+			continue; // only data objects
+		Sym = xalloc(Sym, (SymCount + 1) * sizeof(sym_t));
+		Sym[SymCount].addr = (uint64_t)addr;
+		Sym[SymCount].name = strcpy(xalloc(NULL, strlen(name) + 1), name);
+		SymCount++;
+	}
+
+	fclose(fp);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+const char *sym_name( uint64_t addr )
+{
+	static char buf[4][24];
+	static unsigned idx;
+	size_t i;
+
+	for (i = 0; i < SymCount; i++)
+		if (Sym[i].addr == addr)
+			return Sym[i].name;
+
+	idx = (idx + 1) % 4;
+	sprintf(buf[idx], "0x%08llX", (unsigned long long)addr);
+	return buf[idx];
+}
+
+/* -------------------------------------------------------------------------- */
+// register the track of the task (or timer) 'addr'
+
+static
+void tid_add( uint64_t addr, int tmr )
+{
+	size_t i;
+
+	for (i = 0; i < TidCount; i++)
+		if (Tid[i] == addr)
+			return;
+
+	Tid    = xalloc(Tid,    (TidCount + 1) * sizeof(uint64_t));
+	TidTmr = xalloc(TidTmr, (TidCount + 1) * sizeof(char));
+	Tid   [TidCount] = addr;
+	TidTmr[TidCount] = (char)tmr;
+	TidCount++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+const char *evt_name( unsigned arg, char *buf )
+{
+	switch (arg)
+	{
+	case E_SUCCESS: return "success";
+	case E_TIMEOUT: return "timeout";
+	case E_STOPPED: return "stopped";
+	}
+	sprintf(buf, "%u", arg);
+	return buf;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void put_event( double us, const char *ph, uint64_t tid, const char *name, const char *key, const char *val )
+{
+	static int first = 1;
+
+	fprintf(Out, "%s\n{\"ph\":\"%s\",\"pid\":1,\"tid\":%llu,\"ts\":%.3f,\"name\":\"%s\"",
+	        first ? "" : ",", ph, (unsigned long long)tid, us, name);
+	if (ph[0] == 'i')
+		fprintf(Out, ",\"s\":\"t\"");
+	if (key)
+		fprintf(Out, ",\"args\":{\"%s\":\"%s\"}", key, val);
+	fprintf(Out, "}");
+	first = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// records are read field by field, as the size of the address of the object depends on the target
+
+static
+void get_rec( const unsigned char *rec, unsigned size, uint32_t *time, unsigned *type, unsigned *arg, uint64_t *obj )
+{
+	uint32_t t32;
+	uint16_t t16;
+	uint64_t t64;
+
+	memcpy(&t32, rec + offsetof(trc_rec_t, time), sizeof(t32)); *time = get32(t32);
+	memcpy(&t16, rec + offsetof(trc_rec_t, type), sizeof(t16)); *type = get16(t16);
+	memcpy(&t16, rec + offsetof(trc_rec_t, arg),  sizeof(t16)); *arg  = get16(t16);
+
+	if (size - offsetof(trc_rec_t, obj) == sizeof(uint64_t))
+	{
+		memcpy(&t64, rec + offsetof(trc_rec_t, obj), sizeof(t64)); *obj = get64(t64);
+	}
+	else
+	{
+		memcpy(&t32, rec + offsetof(trc_rec_t, obj), sizeof(t32)); *obj = get32(t32);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void decode( const trc_hdr_t *hdr, const unsigned char *data )
+{
+	unsigned size  = hdr->size;
+	uint32_t count = get16(hdr->count);
+	uint32_t head  = get32(hdr->head);
+	uint32_t freq  = get32(hdr->freq);
+	uint32_t num   = head < count ? head : count;
+	uint64_t cur   = 0, obj;
+	uint32_t stamp, prev = 0, i;
+	unsigned type, arg;
+	uint64_t time  = 0;
+	double   us    = 0;
+	char     name[512], buf[32];
+
+	if (!Text)
+		fprintf(Out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+	for (i = head - num; i != head; i++)
+	{
+		get_rec(data + (size_t)(i & (count - 1)) * size, size, &stamp, &type, &arg, &obj);
+
+		if (i != head - num)
+			time += (uint32_t)(stamp - prev);
+		prev = stamp;
+		us = (double)time * 1e6 / freq;
+
+		if (Text)
+			fprintf(Out, "%14.3f us  %-16s ", us, cur ? sym_name(cur) : "?");
+
+		switch (type)
+		{
+		case TRC_SWITCH:
+			if (Text)
+			{
+				fprintf(Out, "switch to %s\n", sym_name(obj));
+			}
+			else
+			{
+				if (cur)
+					put_event(us, "E", cur, "running", NULL, NULL);
+				put_event(us, "B", obj, "running", NULL, NULL);
+			}
+			tid_add(obj, 0);
+			cur = obj;
+			break;
+
+		case TRC_WAIT:
+			sprintf(name, "wait %s", sym_name(obj));
+			sprintf(buf, "%u", arg);
+			if (Text)
+				fprintf(Out, "%s, delay %s\n", name, arg == 0xFFFFU ? "infinite" : buf);
+			else
+				put_event(us, "i", obj, "wait", "delay", arg == 0xFFFFU ? "infinite" : buf);
+			tid_add(obj, 0);
+			break;
+
+		case TRC_WAKEUP:
+			sprintf(name, "wakeup %s", sym_name(obj));
+			if (Text)
+				fprintf(Out, "%s, event %s\n", name, evt_name(arg, buf));
+			else
+				put_event(us, "i", obj, "wakeup", "event", evt_name(arg, buf));
+			tid_add(obj, 0);
+			break;
+
+		case TRC_TIMER:
+			if (Text)
+				fprintf(Out, "timer %s\n", sym_name(obj));
+			else
+				put_event(us, "i", obj, "timer", NULL, NULL);
+			tid_add(obj, 1);
+			break;
+
+		case TRC_GIVE:
+		case TRC_TAKE:
+			sprintf(name, "%s %s", type == TRC_GIVE ? "give" : "take", sym_name(obj));
+			if (Text)
+				fprintf(Out, "%s, %s\n", name, evt_name(arg, buf));
+			else
+				put_event(us, "i", cur, name, "result", evt_name(arg, buf));
+			break;
+
+		case TRC_LOCK:
+			sprintf(name, "lock window %s", sym_name(obj));
+			sprintf(buf, "%.3f us%s", (double)arg * 1e6 / freq, arg == 0xFFFFU ? "+" : "");
+			if (Text)
+				fprintf(Out, "%s, new maximum %s\n", name, buf);
+			else
+				put_event(us, "i", cur, name, "maximum", buf);
+			break;
+
+		default:
+			if (Text)
+				fprintf(Out, "unknown record %u\n", type);
+			break;
+		}
+	}
+
+	if (Text)
+		return;
+
+	if (cur)
+		put_event(us, "E", cur, "running", NULL, NULL);
+
+	for (i = 0; i < TidCount; i++)
+	{
+		sprintf(name, "%s%s", TidTmr[i] ? "timer " : "", sym_name(Tid[i]));
+		put_event(0, "M", Tid[i], "thread_name", "name", name);
+	}
+
+	fprintf(Out, "\n]}\n");
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void usage( void )
+{
+	fprintf(stderr, "usage: ostrace [-t] [-s symbols] [-o output] dump\n");
+	exit(EXIT_FAILURE);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char **argv )
+{
+	const char *output = NULL;
+	const char *input  = NULL;
+	trc_hdr_t   hdr;
+	unsigned char * data;
+	uint32_t    count;
+	FILE      * fp;
+	int         i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0)
+			Text = 1;
+		else
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			sym_load(argv[++i]);
+		else
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			output = argv[++i];
+		else
+		if (argv[i][0] != '-' && input == NULL)
+			input = argv[i];
+		else
+			usage();
+	}
+
+	if (input == NULL)
+		usage();
+
+	fp = fopen(input, "rb");
+	if (fp == NULL)
+	{
+		perror(input);
+		return EXIT_FAILURE;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1)
+	{
+		fprintf(stderr, "%s: too short\n", input);
+		return EXIT_FAILURE;
+	}
+
+	Swap = hdr.magic != TRC_MAGIC;
+	if (get32(hdr.magic) != TRC_MAGIC || hdr.version != TRC_VERSION)
+	{
+		fprintf(stderr, "%s: not a StateOS trace (version %u)\n", input, TRC_VERSION);
+		return EXIT_FAILURE;
+	}
+
+	count = get16(hdr.count);
+	if (count == 0 || (count & (count - 1)) || get32(hdr.freq) == 0 ||
+	   (hdr.size != offsetof(trc_rec_t, obj) + sizeof(uint32_t) && hdr.size != offsetof(trc_rec_t, obj) + sizeof(uint64_t)))
+	{
+		fprintf(stderr, "%s: corrupted header\n", input);
+		return EXIT_FAILURE;
+	}
+
+	data = xalloc(NULL, (size_t)count * hdr.size);
+	if (fread(data, hdr.size, count, fp) != count)
+	{
+		fprintf(stderr, "%s: incomplete buffer\n", input);
+		return EXIT_FAILURE;
+	}
+	fclose(fp);
+
+	Out = output ? fopen(output, "w") : stdout;
+	if (Out == NULL)
+	{
+		perror(output);
+		return EXIT_FAILURE;
+	}
+
+	decode(&hdr, data);
+
+	if (Out != stdout)
+		fclose(Out);
+
+	return EXIT_SUCCESS;
+}